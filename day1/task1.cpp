@@ -1,53 +1,145 @@
-#include <filesystem>
-#include <fmt/core.h>
-#include <fstream>
-#include <range/v3/all.hpp>
+#include "instrument.hpp"
+#include "mapped_file.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
-int main(int argc, char *argv[]) {
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-  std::vector<std::string_view> args{};
-  for (int i = 0; i < argc; ++i) {
-    args.push_back({argv[i], std::strlen(argv[i])});
-  }
+namespace {
+
+// digit and newline bits of the 64 bytes at p, bit i is byte i
+struct byte_classes {
+  std::uint64_t digits;
+  std::uint64_t newlines;
+};
 
-  if (argc < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+byte_classes classify(char const *p) {
+#ifdef __AVX2__
+  auto half = [](char const *q) {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(q));
+    auto values = _mm256_sub_epi8(chunk, _mm256_set1_epi8('0'));
+    auto digits = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+    auto newlines = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+    return byte_classes{
+        static_cast<std::uint32_t>(_mm256_movemask_epi8(digits)),
+        static_cast<std::uint32_t>(_mm256_movemask_epi8(newlines))};
+  };
+  auto low = half(p);
+  auto high = half(p + 32);
+  return {low.digits | high.digits << 32, low.newlines | high.newlines << 32};
+#elif defined(__SSE2__)
+  // the x86-64 baseline, four 16 byte quarters
+  byte_classes out{0, 0};
+  for (int i = 0; i < 4; ++i) {
+    auto chunk =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 16 * i));
+    auto values = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+    auto digits =
+        _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+    auto newlines = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+    out.digits |= std::uint64_t{static_cast<std::uint16_t>(
+                      _mm_movemask_epi8(digits))}
+                  << (16 * i);
+    out.newlines |= std::uint64_t{static_cast<std::uint16_t>(
+                        _mm_movemask_epi8(newlines))}
+                    << (16 * i);
   }
+  return out;
+#else
+  byte_classes out{0, 0};
+  for (int i = 0; i < 64; ++i) {
+    auto digit = static_cast<unsigned char>(p[i] - '0') < 10;
+    out.digits |= std::uint64_t{digit} << i;
+    out.newlines |= std::uint64_t{p[i] == '\n'} << i;
+  }
+  return out;
+#endif
+}
+
+// sum of the calibration values of a run of lines, 64 bytes at a time: the
+// newline bits cut the digit bits into lines, the lowest and highest digit
+// bit of a line are its first and last digit
+std::size_t calibration_sum(std::string_view lines) {
+
+  std::size_t acc{};
+  // first and last digit of the current line so far, first < 0 before any
+  int first = -1;
+  int last = 0;
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+  auto take = [&](char const *block, std::uint64_t digits) {
+    if (digits != 0) {
+      if (first < 0) {
+        first = block[std::countr_zero(digits)] - '0';
+      }
+      last = block[63 - std::countl_zero(digits)] - '0';
+    }
+  };
 
-  ifs.open(path);
+  auto end_line = [&] {
+    if (first >= 0) {
+      acc += first * 10 + last;
+    }
+    first = -1;
+  };
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+  auto run = [&](char const *block) {
+    auto [digits, newlines] = classify(block);
+    while (newlines != 0) {
+      auto before = (newlines & -newlines) - 1;
+      take(block, digits & before);
+      end_line();
+      digits &= ~before;
+      newlines &= newlines - 1;
+    }
+    take(block, digits);
+  };
+
+  std::size_t pos = 0;
+  for (; pos + 64 <= lines.size(); pos += 64) {
+    run(lines.data() + pos);
+  }
+  if (pos < lines.size()) {
+    // zero padded, neither digits nor newlines
+    std::array<char, 64> tail{};
+    std::copy(lines.begin() + pos, lines.end(), tail.begin());
+    run(tail.data());
   }
+  end_line();
 
-  std::string line;
-  std::size_t acc{};
+  return acc;
+}
 
-  while (ifs >> line) {
+struct solution {
 
-    auto is_digit = [](char c) -> bool { return c >= '0' && c <= '9'; };
+  explicit solution(args_t const &params) : pool(aoc::make_pool(params)) {}
 
-    int first = ranges::accumulate(line | ranges::views::filter(is_digit) |
-                                       ranges::views::take(1),
-                                   -static_cast<int>('0'));
-    int last = ranges::accumulate(line | ranges::views::reverse |
-                                      ranges::views::filter(is_digit) |
-                                      ranges::views::take(1),
-                                  -static_cast<int>('0'));
+  void parse(std::string_view in) { input = in; }
 
-    acc += (first * 10) + last;
+  std::size_t part1() const {
+    AOC_SCOPE("day1/first_last_digit");
+    return aoc::parallel_reduce_lines(pool.get(), input, std::size_t{0},
+                                      calibration_sum, std::plus<>{});
   }
 
-  fmt::println("{}", acc);
+  std::string_view input;
+  std::unique_ptr<aoc::thread_pool> pool;
+};
 
-  return 0;
-}
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day1_task1", "day1/input.txt");
+
+} // namespace
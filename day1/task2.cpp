@@ -1,92 +1,186 @@
-#include "trie.hpp"
+#include "aho_corasick.hpp"
+#include "args.hpp"
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+#include "tokenizer.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
+#include <functional>
+#include <memory>
 #include <range/v3/all.hpp>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
-int main(int argc, char *argv[]) {
+namespace {
+
+// one "<word> <value>" per line, blank lines and '#' comments are skipped,
+// --dict <file> replaces this with a file in the same format
+constexpr std::string_view builtin_dictionary = R"(# english
+one 1
+1 1
+two 2
+2 2
+three 3
+3 3
+four 4
+4 4
+five 5
+5 5
+six 6
+6 6
+seven 7
+7 7
+eight 8
+8 8
+nine 9
+9 9
+zero 0
+0 0
+)";
+
+// a line that is not exactly a word and a number throws
+std::vector<aoc::trie_entry> read_dictionary(std::string_view text) {
+  std::vector<aoc::trie_entry> words;
+  std::size_t line_no = 0;
+  for (std::string_view line : line_range{text}) {
+    ++line_no;
+    auto [word, value, rest] = aoc::first_tokens<3>(line, " \t\r");
+    if (word.empty() or word.starts_with('#')) {
+      continue;
+    }
+    int val = 0;
+    auto [end, ec] =
+        std::from_chars(value.data(), value.data() + value.size(), val);
+    if (value.empty() or ec != std::errc{} or
+        end != value.data() + value.size() or !rest.empty()) {
+      throw std::runtime_error(
+          fmt::format("dictionary line {}: expected <word> <value>, got '{}'",
+                      line_no, line));
+    }
+    words.push_back({word, val});
+  }
+  return words;
+}
+
+// FNV-1a, ties a cached automaton to the dictionary it was built from
+std::uint64_t fingerprint(std::string_view text) {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (char c : text) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+  }
+  return hash;
+}
 
-  std::vector<std::string_view> args{};
-  for (int i = 0; i < argc; ++i) {
-    args.push_back({argv[i], std::strlen(argv[i])});
+// --dict-cache <file> keeps the compiled automaton between runs, prefixed
+// with the dictionary fingerprint, and is rewritten when that does not match
+aoc::aho_corasick load_digits(args_t const &params) {
+  mapped_file dict_file;
+  auto text = builtin_dictionary;
+  if (auto path = option(params, "--dict")) {
+    dict_file = mapped_file(std::filesystem::path(*path));
+    if (!dict_file.good()) {
+      throw std::runtime_error(fmt::format("cannot read dictionary {}", *path));
+    }
+    text = dict_file.view();
+  }
+
+  auto key = fingerprint(text);
+  auto cache = option(params, "--dict-cache");
+  if (cache) {
+    mapped_file cached{std::filesystem::path(*cache)};
+    auto bytes = cached.view();
+    std::uint64_t stored = 0;
+    if (bytes.size() >= sizeof(stored)) {
+      std::memcpy(&stored, bytes.data(), sizeof(stored));
+      if (stored == key) {
+        if (auto ac = aoc::aho_corasick::deserialize(bytes.substr(8))) {
+          return std::move(*ac);
+        }
+      }
+    }
+    AOC_INFO("rebuilding dictionary cache {}", *cache);
   }
 
-  if (argc < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+  auto words = read_dictionary(text);
+  aoc::aho_corasick ac(words);
+
+  if (cache) {
+    // written aside and renamed over the cache, so a concurrent or
+    // interrupted run never leaves a partial file under the real name
+    auto bytes = ac.serialize();
+    std::filesystem::path target(*cache);
+    auto temp = target;
+    temp += ".tmp";
+    std::FILE *out = std::fopen(temp.c_str(), "wb");
+    bool written = out and std::fwrite(&key, sizeof(key), 1, out) == 1 and
+                   std::fwrite(bytes.data(), 1, bytes.size(), out) ==
+                       bytes.size();
+    if (out and std::fclose(out) != 0) {
+      written = false;
+    }
+    std::error_code ec;
+    if (written) {
+      std::filesystem::rename(temp, target, ec);
+    }
+    if (!written or ec) {
+      std::filesystem::remove(temp, ec);
+      AOC_WARN("cannot write dictionary cache {}", *cache);
+    }
   }
+  return ac;
+}
+
+struct solution {
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+  explicit solution(args_t const &params)
+      : pool(aoc::make_pool(params)), digits(load_digits(params)) {}
 
-  ifs.open(path);
+  void parse(std::string_view in) { input = in; }
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+  std::size_t part2() const {
+    AOC_SCOPE("day1/digit_scan");
+    return aoc::parallel_reduce_lines(
+        pool.get(), input, std::size_t{0},
+        [this](std::string_view lines) { return calibration_sum(lines); },
+        std::plus<>{});
   }
 
-  std::string line;
-  std::size_t acc{};
-
-  trie prefix_tree = {{"one", 1},   {"1", 1}, {"two", 2},   {"2", 2},
-                      {"three", 3}, {"3", 3}, {"four", 4},  {"4", 4},
-                      {"five", 5},  {"5", 5}, {"six", 6},   {"6", 6},
-                      {"seven", 7}, {"7", 7}, {"eight", 8}, {"8", 8},
-                      {"nine", 9},  {"9", 9}, {"zero", 0},  {"0", 0}};
-
-  trie suffix_tree = {{"eno", 1},   {"1", 1}, {"owt", 2},   {"2", 2},
-                      {"eerht", 3}, {"3", 3}, {"ruof", 4},  {"4", 4},
-                      {"evif", 5},  {"5", 5}, {"xis", 6},   {"6", 6},
-                      {"neves", 7}, {"7", 7}, {"thgie", 8}, {"8", 8},
-                      {"enin", 9},  {"9", 9}, {"orez", 0},  {"0", 0}};
-
-  auto get_first_full_prefix = [](trie const &prefix_tree,
-                                  std::string_view line) {
-    int prefix = 0;
-
-    int start = 0;
-    std::size_t size = 1;
-    std::string_view substr{line.data() + start, size};
-
-    do {
-
-      // find first matching prefix char
-      while (!prefix_tree.has_prefix(substr)) {
-        ++start;
-        if (start == line.size()) {
-          throw std::out_of_range(
-              "prefix cannot be found in the input string :<");
-        }
-        size = 1;
-        substr = std::string_view{line.data() + start, size};
-      }
+  // sum of the calibration values of a run of lines
+  std::size_t calibration_sum(std::string_view lines) const {
 
-      if (auto opt_val = prefix_tree.search(substr); opt_val) {
-        // found entry
-        return *opt_val;
-      } else {
-        // not found, increase window size
-        substr = std::string_view{line.data() + start, ++size};
-      }
+    std::size_t acc{};
 
-    } while (true);
-  };
+    for (std::string_view line : line_range{lines}) {
+      if (line.empty()) {
+        continue;
+      }
+      auto [first, last] = digits.scan(line);
+      if (!first) {
+        throw std::out_of_range("no digit in the input string :<");
+      }
+      acc += first->value * 10 + last->value;
+    }
 
-  while (ifs >> line) {
-    int first = get_first_full_prefix(prefix_tree, line);
-    std::reverse(line.begin(), line.end());
-    int second = get_first_full_prefix(suffix_tree, line);
-    acc += first * 10 + second;
+    return acc;
   }
 
-  fmt::println("{}", acc);
+  std::string_view input;
+  std::unique_ptr<aoc::thread_pool> pool;
+  aoc::aho_corasick digits;
+};
 
-  return 0;
-}
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day1_task2", "day1/input.txt");
+
+} // namespace
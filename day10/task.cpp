@@ -1,11 +1,11 @@
-#include "args.hpp"
-#include "range_split_strs.hpp"
-#include <_ctype.h>
+#include "instrument.hpp"
+#include "mapped_file.hpp"
+#include "solver.hpp"
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <functional>
 #include <iterator>
 #include <map>
@@ -17,6 +17,8 @@
 #include <utility>
 #include <vector>
 
+namespace {
+
 namespace hash_util {
 
 inline void hash_combine(std::size_t &) {}
@@ -43,12 +45,16 @@ template <typename... Types> inline std::size_t hash_val(const Types &...args) {
 
 enum class dir { up, down, left, right };
 
+} // namespace
+
 template <> struct std::hash<std::pair<dir, char>> {
   std::size_t operator()(std::pair<dir, char> const &p) const {
     return hash_util::hash_val(p.first, p.second);
   }
 };
 
+namespace {
+
 struct pos2 {
   int x;
   int y;
@@ -125,6 +131,8 @@ dir opposite_to(dir d) {
   return static_cast<dir>(i);
 }
 
+} // namespace
+
 template <> struct fmt::formatter<dir> {
   template <typename ParseContext> constexpr auto parse(ParseContext &ctx) {
     return ctx.begin();
@@ -149,185 +157,198 @@ template <> struct fmt::formatter<pos2> {
   }
 };
 
-int main(int argc, char **argv) {
-
-  auto args = parse_args(argc, argv);
-
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
-  }
-
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+namespace {
+
+char pipe_from_dirs(dir from, dir to) {
+  if (from == dir::up) {
+    switch (to) {
+    case dir::left:
+      return 'J';
+    case dir::down:
+      return '|';
+    case dir::right:
+      return 'L';
+    default:
+      assert(false);
+    }
+  } else if (from == dir::down) {
+    switch (to) {
+    case dir::left:
+      return '7';
+    case dir::up:
+      return '|';
+    case dir::right:
+      return 'F';
+    default:
+      assert(false);
+    }
 
-  ifs.open(path);
+  } else if (from == dir::left) {
+    switch (to) {
+    case dir::up:
+      return 'J';
+    case dir::down:
+      return '7';
+    case dir::right:
+      return '-';
+    default:
+      assert(false);
+    }
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+  } else {
+    switch (to) {
+    case dir::left:
+      return '-';
+    case dir::down:
+      return 'F';
+    case dir::up:
+      return 'L';
+    default:
+      assert(false);
+    }
   }
+  return '.';
+}
 
-  using std::string;
-  using std::vector;
+dir next(dir entering_from, char pipe) {
+  static std::unordered_map<std::pair<dir, char>, dir> const directed_pipes = {
+      {{dir::up, '|'}, dir::up},     {{dir::down, '|'}, dir::down},
+      {{dir::left, '-'}, dir::left}, {{dir::right, '-'}, dir::right},
+      {{dir::down, 'J'}, dir::left}, {{dir::right, 'J'}, dir::up},
+      {{dir::left, 'F'}, dir::down}, {{dir::up, 'F'}, dir::right},
+      {{dir::left, 'L'}, dir::up},   {{dir::down, 'L'}, dir::right},
+      {{dir::up, '7'}, dir::left},   {{dir::right, '7'}, dir::down},
+  };
 
-  vector<string> pipes;
-  pos2 start_pos;
+  assert(directed_pipes.contains({entering_from, pipe}));
+  return directed_pipes.at({entering_from, pipe});
+}
 
-  string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
-      continue;
-    }
-    if (auto it = line.find('S'); it != string::npos) {
-      start_pos = {static_cast<int>(pipes.size()), static_cast<int>(it)};
-    }
-    pipes.push_back(line);
-  }
+bool is_turn(char pipe) {
+  if (pipe == '|' or pipe == '-' or pipe == '.')
+    return false;
+  else
+    return true;
+}
 
-  int width = pipes.front().size();
-  int height = pipes.size();
+int calc_area(std::vector<pos2> const &vertices) {
+  int area =
+      ranges::fold_left(
+          ranges::views::zip(
+              vertices, ranges::views::concat(
+                            vertices | ranges::views::drop(1),
+                            ranges::views::single(ranges::front(vertices)))),
+          0,
+          [](int a, std::tuple<pos2, pos2> t) -> int {
+            return a + std::get<0>(t).x * std::get<1>(t).y -
+                   std::get<0>(t).y * std::get<1>(t).x;
+          }) /
+      2;
+  return std::abs(area);
+}
 
-  auto move = [=](pos2 from, dir d) -> pos2 {
-    auto to = from + d;
-    return {std::clamp(to.x, 0, height), std::clamp(to.y, 0, height)};
-  };
+struct solution {
 
-  auto pipe_at = [&pipes](pos2 const &coord) -> char {
-    assert(!pipes.empty());
-    assert(coord.x >= 0 and coord.x < pipes.size());
-    assert(coord.y >= 0 and coord.y < pipes.front().size());
-    return pipes[coord.x][coord.y];
-  };
+  void parse(std::string_view input) {
+    AOC_SCOPE("day10/parse_pipes");
+    using std::string;
+    using std::vector;
 
-  vector<dir> dirs = {dir::up, dir::down, dir::left, dir::right};
-  auto potential_dirs =
-      dirs | ranges::views::filter([=, &pipes](dir d) {
-        pos2 adj_pipe = move(start_pos, d);
-
-        return connects_with_dir(pipe_at(adj_pipe), opposite_to(d));
-      }) |
-      ranges::to_vector;
-
-  auto pipe_from_dirs = [](dir from, dir to) {
-    if (from == dir::up) {
-      switch (to) {
-      case dir::left:
-        return 'J';
-      case dir::down:
-        return '|';
-      case dir::right:
-        return 'L';
-      default:
-        assert(false);
+    for (std::string_view line : line_range{input}) {
+      if (line.empty()) {
+        continue;
       }
-    } else if (from == dir::down) {
-      switch (to) {
-      case dir::left:
-        return '7';
-      case dir::up:
-        return '|';
-      case dir::right:
-        return 'F';
-      default:
-        assert(false);
+      if (auto it = line.find('S'); it != std::string_view::npos) {
+        start_pos = {static_cast<int>(pipes.size()), static_cast<int>(it)};
       }
+      pipes.emplace_back(line);
+    }
 
-    } else if (from == dir::left) {
-      switch (to) {
-      case dir::up:
-        return 'J';
-      case dir::down:
-        return '7';
-      case dir::right:
-        return '-';
-      default:
-        assert(false);
-      }
+    int width = pipes.front().size();
+    int height = pipes.size();
 
-    } else {
-      switch (to) {
-      case dir::left:
-        return '-';
-      case dir::down:
-        return 'F';
-      case dir::up:
-        return 'L';
-      default:
-        assert(false);
-      }
-    }
-  };
-  pipes[start_pos.x][start_pos.y] =
-      pipe_from_dirs(potential_dirs.front(), potential_dirs.back());
+    auto move = [=](pos2 from, dir d) -> pos2 {
+      auto to = from + d;
+      return {std::clamp(to.x, 0, height), std::clamp(to.y, 0, height)};
+    };
 
-  // fmt::println("no need to drop dead ends from potential starting points");
-  assert(potential_dirs.size() == 2);
+    vector<dir> dirs = {dir::up, dir::down, dir::left, dir::right};
+    potential_dirs = dirs | ranges::views::filter([=, this](dir d) {
+                       pos2 adj_pipe = move(start_pos, d);
 
-  std::unordered_map<std::pair<dir, char>, dir> const directed_pipes = {
-      {{dir::up, '|'}, dir::up},     {{dir::down, '|'}, dir::down},
-      {{dir::left, '-'}, dir::left}, {{dir::right, '-'}, dir::right},
-      {{dir::down, 'J'}, dir::left}, {{dir::right, 'J'}, dir::up},
-      {{dir::left, 'F'}, dir::down}, {{dir::up, 'F'}, dir::right},
-      {{dir::left, 'L'}, dir::up},   {{dir::down, 'L'}, dir::right},
-      {{dir::up, '7'}, dir::left},   {{dir::right, '7'}, dir::down},
-  };
+                       return connects_with_dir(pipe_at(adj_pipe),
+                                                opposite_to(d));
+                     }) |
+                     ranges::to_vector;
 
-  auto next = [&directed_pipes](dir entering_from, char pipe) -> dir {
-    assert(directed_pipes.contains({entering_from, pipe}));
-    return directed_pipes.at({entering_from, pipe});
-  };
+    pipes[start_pos.x][start_pos.y] =
+        pipe_from_dirs(potential_dirs.front(), potential_dirs.back());
 
-  auto is_turn = [](char pipe) -> bool {
-    if (pipe == '|' or pipe == '-' or pipe == '.')
-      return false;
-    else
-      return true;
-  };
+    // fmt::println("no need to drop dead ends from potential starting points");
+    assert(potential_dirs.size() == 2);
+  }
+
+  // furthest point from start
+  int part1() {
+    trace_loop();
+    return steps / 2;
+  }
 
-  vector<pos2> loop_turns;
+  // points inside loop
+  int part2() {
+    trace_loop();
+    AOC_SCOPE("day10/shoelace");
+    return calc_area(loop_turns) - steps / 2 + 1;
+  }
 
-  if (is_turn(pipe_at(start_pos))) {
-    loop_turns.push_back(start_pos);
+private:
+  char pipe_at(pos2 const &coord) const {
+    assert(!pipes.empty());
+    assert(coord.x >= 0 and coord.x < pipes.size());
+    assert(coord.y >= 0 and coord.y < pipes.front().size());
+    return pipes[coord.x][coord.y];
   }
 
-  pos2 prev = start_pos;
-  dir step_dir = potential_dirs.front();
-  pos2 curr = prev + step_dir;
-  int steps = 1;
+  // walks the loop once, both parts share the result
+  void trace_loop() {
+    if (steps) {
+      return;
+    }
+    AOC_SCOPE("day10/trace_loop");
 
-  while (curr != start_pos) {
-    if (is_turn(pipe_at(curr))) {
-      loop_turns.push_back(curr);
+    if (is_turn(pipe_at(start_pos))) {
+      loop_turns.push_back(start_pos);
     }
 
-    prev = curr;
-    dir move_dir = next(step_dir, pipe_at(curr));
-    curr = curr + move_dir;
-    ++steps;
-    step_dir = move_dir;
+    pos2 prev = start_pos;
+    dir step_dir = potential_dirs.front();
+    pos2 curr = prev + step_dir;
+    steps = 1;
+
+    while (curr != start_pos) {
+      if (is_turn(pipe_at(curr))) {
+        loop_turns.push_back(curr);
+      }
+
+      prev = curr;
+      dir move_dir = next(step_dir, pipe_at(curr));
+      curr = curr + move_dir;
+      ++steps;
+      step_dir = move_dir;
+    }
+    AOC_COUNT("day10/loop_steps", steps);
+    AOC_COUNT("day10/loop_turns", loop_turns.size());
   }
 
-  auto calc_area = [](vector<pos2> const &vertices) {
-    int area =
-        ranges::fold_left(
-            ranges::views::zip(
-                vertices, ranges::views::concat(
-                              vertices | ranges::views::drop(1),
-                              ranges::views::single(ranges::front(vertices)))),
-            0,
-            [](int a, std::tuple<pos2, pos2> t) -> int {
-              return a + std::get<0>(t).x * std::get<1>(t).y -
-                     std::get<0>(t).y * std::get<1>(t).x;
-            }) /
-        2;
-    return std::abs(area);
-  };
+  std::vector<std::string> pipes;
+  pos2 start_pos;
+  std::vector<dir> potential_dirs;
+
+  std::vector<pos2> loop_turns;
+  int steps{0};
+};
 
-  int inside_points = calc_area(loop_turns) - steps / 2 + 1;
-  fmt::println("furthest point from start: {}\npoints inside loop: {}",
-               steps / 2, inside_points);
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day10", "day10/input");
 
-  return 0;
-}
+} // namespace
@@ -1,10 +1,12 @@
-#include "args.hpp"
-#include "pos2.hpp"
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "solver.hpp"
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <functional>
 #include <iterator>
 #include <map>
@@ -12,117 +14,112 @@
 #include <set>
 #include <string>
 #include <string_view>
-#include <sys/_types/_int64_t.h>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
-int main(int argc, char **argv) {
+namespace {
 
-  auto args = parse_args(argc, argv);
+// galaxy position, x is the row and y the column after expansion
+struct pos2 {
+  pos2(std::int64_t _x, std::int64_t _y) : x(_x), y(_y) {}
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
-  }
-
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+  std::int64_t x;
+  std::int64_t y;
+};
 
-  ifs.open(path);
+} // namespace
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+template <> struct fmt::formatter<pos2> {
+  template <typename ParseContext>
+  constexpr auto parse(ParseContext &ctx) const {
+    return ctx.begin();
   }
+  template <typename FormatContext>
+  auto format(pos2 const &pos, FormatContext &ctx) const {
+    return fmt::format_to(ctx.out(), "({},{})", pos.x, pos.y);
+  }
+};
 
-  using std::string;
-  using std::vector;
+namespace {
 
-  char const galaxy_symbol = '#';
+struct solution {
 
-  int width = 0;
-  int height = 0;
+  void parse(std::string_view input) {
+    AOC_SCOPE("day11/parse_galaxies");
+    using std::string;
+    using std::vector;
 
-  auto less_y = [](pos2 l, pos2 r) {
-    if (l.y < r.y) {
-      return true;
-    } else {
-      return l.x < r.x;
-    }
-  };
+    char const galaxy_symbol = '#';
 
-  vector<pos2> galaxies;
+    int width = 0;
+    int height = 0;
 
-  size_t expansion_factor = 1000000;
+    vector<size_t> can_col_expand;
+    for (std::string_view line : line_range{input}) {
+      if (width == 0) {
+        width = line.size();
+        can_col_expand = vector<size_t>(width, true);
+      }
 
-  vector<size_t> can_col_expand;
-  string line;
-  while (std::getline(ifs, line)) {
-    if (width == 0) {
-      width = line.size();
-      can_col_expand = vector<size_t>(width, true);
+      // no galaxy in a row
+      if (auto it = line.find(galaxy_symbol); it == std::string_view::npos) {
+        height += expansion_factor;
+      } else {
+        while (it != std::string_view::npos) {
+          pos2 glxy(height, static_cast<std::int64_t>(it));
+          galaxies.push_back(glxy);
+          AOC_TRACE("galaxies: {} {}", galaxies.size(), galaxies);
+          can_col_expand.at(it) = false;
+
+          it = line.find(galaxy_symbol, it + 1);
+        }
+        ++height;
+      }
     }
-
-    // no galaxy in a row
-    if (auto it = line.find(galaxy_symbol); it == string::npos) {
-      height += expansion_factor;
-    } else {
-      while (it != string::npos) {
-        pos2 glxy(height, it);
-        galaxies.push_back(glxy);
-        fmt::println("galaxies: {} {}", galaxies.size(), galaxies);
-        can_col_expand.at(it) = false;
-
-        it = line.find(galaxy_symbol, it + 1);
+    AOC_DEBUG("galaxies: {}", galaxies);
+
+    vector<size_t> cols_to_expand =
+        ranges::views::enumerate(can_col_expand) |
+        ranges::views::filter(
+            [](auto const &t) { return std::get<1>(t) == 1; }) |
+        ranges::views::transform(
+            [](auto const &t) { return static_cast<size_t>(std::get<0>(t)); }) |
+        ranges::to_vector;
+
+    ranges::actions::reverse(cols_to_expand);
+    AOC_DEBUG("expand cols: {}", cols_to_expand);
+
+    width += cols_to_expand.size();
+
+    for (size_t exp_c : cols_to_expand) {
+      for (pos2 &glxy : galaxies) {
+        if (glxy.y > static_cast<std::int64_t>(exp_c)) {
+          glxy.y += expansion_factor - 1;
+        }
       }
-      ++height;
     }
+    AOC_DEBUG("galaxies: {}", galaxies);
   }
-  fmt::println("galaxies: {}", galaxies);
 
-  vector<size_t> cols_to_expand =
-      ranges::views::enumerate(can_col_expand) |
-      ranges::views::filter([](auto const &t) { return std::get<1>(t) == 1; }) |
-      ranges::views::transform(
-          [](auto const &t) { return static_cast<size_t>(std::get<0>(t)); }) |
-      ranges::to_vector;
-
-  ranges::actions::reverse(cols_to_expand);
-  fmt::println("expand cols: {}", cols_to_expand);
-
-  width += cols_to_expand.size();
-
-  for (size_t exp_c : cols_to_expand) {
-    for (pos2 &glxy : galaxies) {
-      if (glxy.y > exp_c) {
-        glxy.y += expansion_factor - 1;
+  // total distance
+  size_t part2() const {
+    AOC_SCOPE("day11/pair_distances");
+    size_t distance_total{0};
+    for (int i = 0; i < galaxies.size() - 1; ++i) {
+      for (int j = i + 1; j < galaxies.size(); ++j) {
+        distance_total += std::abs(galaxies[i].x - galaxies[j].x) +
+                          std::abs(galaxies[i].y - galaxies[j].y);
       }
     }
+    return distance_total;
   }
-  fmt::println("galaxies: {}", galaxies);
-
-  /* for (size_t h = 0; h < height; ++h) { */
-  /*   string line(width, '.'); */
-  /*   for (size_t w = 0; w < width; ++w) { */
-  /*     if (std::find(galaxies.begin(), galaxies.end(), pos2{h, w}) != */
-  /*         galaxies.end()) { */
-  /*       line[w] = '#'; */
-  /*     } */
-  /*   } */
-  /*   fmt::println("{}", line); */
-  /* } */
-
-  size_t distance_total{0};
-  for (int i = 0; i < galaxies.size() - 1; ++i) {
-    for (int j = i + 1; j < galaxies.size(); ++j) {
-      distance_total += std::abs(galaxies[i].x - galaxies[j].x) +
-                        std::abs(galaxies[i].y - galaxies[j].y);
-    }
-  }
 
-  fmt::println("total distance; {}", distance_total);
+  size_t expansion_factor = 1000000;
+  std::vector<pos2> galaxies;
+};
+
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day11", "day11/input");
 
-  return 0;
-}
+} // namespace
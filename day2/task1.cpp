@@ -1,216 +1,293 @@
 #include "args.hpp"
+#include "instrument.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
-#include <cassert>
-#include <charconv>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <filesystem>
 #include <fmt/core.h>
-#include <fmt/ranges.h>
-#include <fstream>
+#include <functional>
+#include <memory>
 #include <optional>
-#include <range/v3/all.hpp>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <vector>
 
-struct roll {
-  int red;
-  int green;
-  int blue;
+namespace {
 
-  roll() : red(0), green(0), blue(0) {}
-};
-
-struct game {
-  std::vector<roll> rolls;
-};
+// per game maximum of every colour, structure of arrays so the parts are
+// plain loops over contiguous ints
+struct cube_columns {
+  std::vector<int> red;
+  std::vector<int> green;
+  std::vector<int> blue;
 
-auto parse_roll(std::string_view::const_iterator iter) {
+  std::size_t size() const { return red.size(); }
 
-  std::optional<roll> rl;
+  void push_back(std::array<int, 3> const &most) {
+    red.push_back(most[0]);
+    green.push_back(most[1]);
+    blue.push_back(most[2]);
+  }
+};
 
-  return std::pair{rl, iter};
+// combine for parallel_reduce_lines, chunks stay in input order
+cube_columns concat(cube_columns acc, cube_columns const &part) {
+  acc.red.insert(acc.red.end(), part.red.begin(), part.red.end());
+  acc.green.insert(acc.green.end(), part.green.begin(), part.green.end());
+  acc.blue.insert(acc.blue.end(), part.blue.begin(), part.blue.end());
+  return acc;
 }
 
-auto split(std::string_view str, char sep) {
-  std::vector<std::string_view> substrs;
-
-  auto beg = str.begin();
-
-  do {
-
-    auto iter = std::find(beg, str.end(), sep);
-
-    auto len = std::distance(beg, iter);
+// max red, green, blue over the rolls of "Game 1: 3 blue, 4 red; 1 red, ..."
+// in one pass: every number is a count, the letter after it picks the colour
+std::array<int, 3> max_cubes(std::string_view line) {
+  std::array<int, 3> most{};
+  auto pos = line.find(':');
+  pos = pos == std::string_view::npos ? 0 : pos + 1;
 
-    if (len) {
-      substrs.push_back({beg, iter});
+  while (true) {
+    while (pos < line.size() and (line[pos] < '0' or line[pos] > '9')) {
+      ++pos;
     }
-
-    if (iter != str.end()) {
-      ++iter;
+    if (pos == line.size()) {
+      return most;
+    }
+    auto [count, length] = aoc::scan_int<int>(line.substr(pos));
+    pos += length + 1;
+    if (pos >= line.size()) {
+      return most;
+    }
+    switch (line[pos]) {
+    case 'r':
+      most[0] = std::max(most[0], count);
+      break;
+    case 'g':
+      most[1] = std::max(most[1], count);
+      break;
+    case 'b':
+      most[2] = std::max(most[2], count);
+      break;
+    default:
+      break;
     }
-
-    beg = iter;
-
-  } while (beg != str.end());
-
-  return substrs;
-}
-
-// removes leading 'space'
-std::string_view trim_front(std::string_view str) {
-  auto beg = str.begin();
-  while (beg != str.end() && *beg == ' ') {
-    ++beg;
   }
-  return {beg, str.end()};
 }
 
-enum class color { red, green, blue };
-
-template <typename To> std::optional<To> to(std::string_view);
+// Possible game id sums for any bag, after an O(n log n + cells) build:
+// the distinct red, green and blue maxima are ranked and a 3-D prefix sum
+// over the ranks holds, per cell, the ids of every game it dominates. A
+// query is three binary searches and one lookup.
+class dominance_index {
+public:
+  explicit dominance_index(cube_columns const &games)
+      : reds(distinct(games.red)), greens(distinct(games.green)),
+        blues(distinct(games.blue)), stride_g(blues.size() + 1),
+        stride_r(stride_g * (greens.size() + 1)) {
+    auto cells = stride_r * (reds.size() + 1);
+    if (cells > max_cells) {
+      throw std::length_error("day2: too many distinct cube counts to index");
+    }
+    table.assign(cells, 0);
 
-template <> std::optional<color> to(std::string_view str) {
-  if (str == "red") {
-    return color::red;
-  } else if (str == "blue") {
-    return color::blue;
-  } else if (str == "green") {
-    return color::green;
+    for (std::size_t idx = 0; idx < games.size(); ++idx) {
+      table[cell(rank(reds, games.red[idx]), rank(greens, games.green[idx]),
+                 rank(blues, games.blue[idx]))] += idx + 1;
+    }
+    // prefix sums along each axis in turn, index 0 stays the empty row
+    for (std::size_t r = 1; r <= reds.size(); ++r) {
+      for (std::size_t g = 1; g <= greens.size(); ++g) {
+        for (std::size_t b = 1; b <= blues.size(); ++b) {
+          table[cell(r, g, b)] += table[cell(r, g, b - 1)];
+        }
+      }
+    }
+    for (std::size_t r = 1; r <= reds.size(); ++r) {
+      for (std::size_t g = 1; g <= greens.size(); ++g) {
+        for (std::size_t b = 1; b <= blues.size(); ++b) {
+          table[cell(r, g, b)] += table[cell(r, g - 1, b)];
+        }
+      }
+    }
+    for (std::size_t r = 1; r <= reds.size(); ++r) {
+      for (std::size_t g = 1; g <= greens.size(); ++g) {
+        for (std::size_t b = 1; b <= blues.size(); ++b) {
+          table[cell(r, g, b)] += table[cell(r - 1, g, b)];
+        }
+      }
+    }
   }
 
-  return std::nullopt;
-}
-
-template <> std::optional<int> to(std::string_view str) {
-
-  int out;
-  std::from_chars_result const result =
-      std::from_chars(str.data(), str.end(), out);
-
-  if (result.ec == std::errc::invalid_argument ||
-      result.ec == std::errc::result_out_of_range) {
-    return std::nullopt;
+  std::uint64_t possible_id_sum(int red, int green, int blue) const {
+    return table[cell(rank(reds, red), rank(greens, green),
+                      rank(blues, blue))];
   }
 
-  return out;
-}
-
-template <> std::optional<roll> to(std::string_view str) {
-
-  // split each color cubes count
-  auto cubes = split(str, ',');
+private:
+  // 2^26 cells, half a gigabyte of sums
+  static constexpr std::size_t max_cells = std::size_t{1} << 26;
 
-  roll rl;
+  static std::vector<int> distinct(std::vector<int> values) {
+    std::ranges::sort(values);
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+  }
 
-  // for each xxx red / yyy blue / zzz green
-  for (auto cube : cubes) {
+  // how many of the sorted values are <= value
+  static std::size_t rank(std::vector<int> const &sorted, int value) {
+    return std::ranges::upper_bound(sorted, value) - sorted.begin();
+  }
 
-    auto r = split(cube, ' ');
+  std::size_t cell(std::size_t r, std::size_t g, std::size_t b) const {
+    return r * stride_r + g * stride_g + b;
+  }
 
-    auto cnt = to<int>(r[0]);
-    auto col = to<color>(r[1]);
+  std::vector<int> reds;
+  std::vector<int> greens;
+  std::vector<int> blues;
+  std::size_t stride_g;
+  std::size_t stride_r;
+  std::vector<std::uint64_t> table;
+};
 
-    if (cnt && col) {
-      switch (*col) {
-      case color::blue:
-        rl.blue += *cnt;
-        break;
-      case color::red:
-        rl.red += *cnt;
-        break;
-      case color::green:
-        rl.green += *cnt;
-        break;
-      default:
-        break;
+// the text of --queries, a file or "-" for stdin; stdin can only be read once
+// so later runs in the same process reuse what the first one got
+std::string read_queries(std::string_view source) {
+  if (source == "-") {
+    static std::string const from_stdin = [] {
+      std::string text;
+      char buf[4096];
+      while (auto n = std::fread(buf, 1, sizeof(buf), stdin)) {
+        text.append(buf, n);
       }
-    } else {
-      return std::nullopt;
-    }
+      return text;
+    }();
+    return from_stdin;
   }
-
-  return rl;
+  mapped_file file(std::filesystem::path{source});
+  if (!file.good()) {
+    throw std::runtime_error(fmt::format("cannot read queries {}", source));
+  }
+  return std::string(file.view());
 }
 
-auto parse_line(std::string_view str) {
-
-  // remove "Game xxx: " prefix
-  str = split(str, ':')[1];
-
-  // split game into rolls
-  auto rolls_str = split(str, ';');
-
-  std::vector<roll> rolls;
-  ranges::for_each(rolls_str, [&rolls](std::string_view roll_str) {
-    auto trimmed = trim_front(roll_str);
-
-    auto opt_roll = to<roll>(trimmed);
-    if (opt_roll) {
-      rolls.push_back(*opt_roll);
+struct solution {
+
+  // bag contents, the puzzle's 12 red, 13 green, 14 blue unless given as
+  // <red_cubes> <green_cubes> <blue_cubes>, --threads N parallelizes.
+  // --queries <file> also answers one "<red> <green> <blue>" bag per line
+  explicit solution(args_t const &params) : pool(aoc::make_pool(params)) {
+    if (auto cubes = positional(params, {"--threads", "--queries"});
+        cubes.size() >= 3) {
+      red_cubes = aoc::parse_int<int>(cubes[0]);
+      green_cubes = aoc::parse_int<int>(cubes[1]);
+      blue_cubes = aoc::parse_int<int>(cubes[2]);
+    }
+    if (auto source = option(params, "--queries")) {
+      query_text = read_queries(*source);
     }
-  });
-
-  return rolls;
-}
-
-int main(int argc, char **argv) {
-
-  auto args = parse_args(argc, argv);
-
-  if (args.size() < 5) {
-    fmt::println(
-        "usage: {} <input_file> <red_cubes> <green_cubes> <blue_cubes>",
-        std::filesystem::path(args[0]).filename().string());
-    return -1;
   }
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
-
-  ifs.open(path);
-
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+  void parse(std::string_view input) {
+    AOC_SCOPE("day2/parse_games");
+    games = aoc::parallel_reduce_lines(
+        pool.get(), input, cube_columns{},
+        [](std::string_view lines) {
+          cube_columns parsed;
+          for (std::string_view line : line_range{lines}) {
+            // a blank line is no game, it must not shift the later ids
+            if (line.find_first_not_of(" \r") == std::string_view::npos) {
+              continue;
+            }
+            parsed.push_back(max_cubes(line));
+          }
+          return parsed;
+        },
+        concat);
+    AOC_COUNT("day2/games", games.size());
   }
 
-  int red_cubes = *to<int>(args[2]);
-  int green_cubes = *to<int>(args[3]);
-  int blue_cubes = *to<int>(args[4]);
-
-  std::size_t acc{};
-  std::size_t acc_power{};
+  std::size_t part1() const {
+    AOC_SCOPE("day2/possible_games");
+
+    // branch free so the loop vectorizes
+    auto id_sum = [this](std::size_t begin, std::size_t end) {
+      std::uint64_t acc{};
+      for (auto idx = begin; idx < end; ++idx) {
+        bool possible = (games.red[idx] <= red_cubes) &
+                        (games.green[idx] <= green_cubes) &
+                        (games.blue[idx] <= blue_cubes);
+        acc += possible * (idx + 1);
+      }
+      return acc;
+    };
 
-  std::string line;
+    return aoc::parallel_reduce(pool.get(), games.size(), std::size_t{0},
+                                id_sum, std::plus<>{});
+  }
 
-  auto is_possible = [](roll const &r, int red, int blue, int green) {
-    return r.red <= red and r.green <= green and r.blue <= blue;
-  };
+  std::size_t part2() const {
+    AOC_SCOPE("day2/min_cubes");
 
-  int game_idx = 1;
-  while (std::getline(ifs, line)) {
+    // the per game maxima are the fewest cubes that make the game possible
+    auto power_sum = [this](std::size_t begin, std::size_t end) {
+      std::uint64_t acc_power{};
+      for (auto idx = begin; idx < end; ++idx) {
+        acc_power += static_cast<std::uint64_t>(games.red[idx]) *
+                     games.green[idx] * games.blue[idx];
+      }
+      return acc_power;
+    };
 
-    auto rolls = parse_line(line);
+    return aoc::parallel_reduce(pool.get(), games.size(), std::size_t{0},
+                                power_sum, std::plus<>{});
+  }
 
-    if (ranges::all_of(rolls, [=](auto const &r) {
-          return is_possible(r, red_cubes, blue_cubes, green_cubes);
-        })) {
-      acc += game_idx;
+  // the id sum of every "<red> <green> <blue>" query bag, one answer per
+  // line in order, nullopt without --queries; any other line throws so the
+  // answers cannot drift from their queries
+  std::optional<std::vector<std::uint64_t>> queries() const {
+    if (!query_text) {
+      return std::nullopt;
     }
+    dominance_index index = [this] {
+      AOC_SCOPE("day2/build_index");
+      return dominance_index(games);
+    }();
+
+    AOC_SCOPE("day2/answer_queries");
+    std::vector<std::uint64_t> answers;
+    std::size_t line_no = 0;
+    for (std::string_view line : line_range{*query_text}) {
+      ++line_no;
+      // one slot more to notice a fourth number
+      std::array<int, 4> bag{};
+      if (aoc::parse_ints(line, std::span<int>(bag)) != 3) {
+        throw std::runtime_error(fmt::format(
+            "query line {}: expected <red> <green> <blue>, got '{}'", line_no,
+            line));
+      }
+      answers.push_back(index.possible_id_sum(bag[0], bag[1], bag[2]));
+    }
+    return answers;
+  }
 
-    int min_red = ranges::max(
-        rolls | ranges::views::transform([](auto const &r) { return r.red; }));
-    int min_blue = ranges::max(
-        rolls | ranges::views::transform([](auto const &r) { return r.blue; }));
-    int min_green =
-        ranges::max(rolls | ranges::views::transform(
-                                [](auto const &r) { return r.green; }));
-
-    acc_power += (min_red * min_blue * min_green);
+  int red_cubes{12};
+  int green_cubes{13};
+  int blue_cubes{14};
+  cube_columns games;
+  std::optional<std::string> query_text;
+  std::unique_ptr<aoc::thread_pool> pool;
+};
 
-    ++game_idx;
-  }
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day2_task1", "day2/input.txt");
 
-  fmt::println("sum of possible game IDs:{}", acc);
-  fmt::println("sum of power of minimum required cubes:{}", acc_power);
-  return 0;
-}
+} // namespace
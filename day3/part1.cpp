@@ -1,168 +1,478 @@
 #include "args.hpp"
+#include "instrument.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
-#include <cassert>
-#include <charconv>
-#include <filesystem>
-#include <fmt/core.h>
-#include <fmt/ranges.h>
-#include <fstream>
-#include <functional>
-#include <numeric>
-#include <optional>
-#include <range/v3/all.hpp>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string_view>
-#include <unordered_set>
+#include <vector>
 
-struct position {
-  int x{};
-  int y{};
-  bool operator==(position const &other) const {
-    return x == other.x and y == other.y;
-  }
-};
+namespace {
 
-struct area {
-  position origin;
-  int width;
-  int height;
+constexpr std::size_t word_bits = 64;
 
-  area() = default;
-  area(position orig, int len) : origin(orig), width(len), height(3) {}
-};
+bool is_digit(char c) { return c >= '0' and c <= '9'; }
 
-struct Part {
-  area area;
-  int val;
-};
+bool is_symbol(char c) {
+  return !is_digit(c) and c != '.' and c != '\r';
+}
+
+// row major bitmap of the schematic with one padding column on either side
+// and one padding row above and below, cell (r, c) is bit c + 1 of row r + 1
+// so the neighbours of border cells need no special case
+struct bitmap {
+  bitmap() = default;
+  bitmap(std::size_t rows, std::size_t cols)
+      : words_per_row((cols + 2 + word_bits - 1) / word_bits),
+        words((rows + 2) * words_per_row, 0) {}
+
+  void set(std::size_t r, std::size_t c) {
+    auto bit = c + 1;
+    words[(r + 1) * words_per_row + bit / word_bits] |=
+        std::uint64_t{1} << (bit % word_bits);
+  }
+
+  // padded row
+  std::span<std::uint64_t const> row(std::size_t pr) const {
+    return {words.data() + pr * words_per_row, words_per_row};
+  }
 
-struct Symbol {
-  bool is_gear;
-  std::vector<int> adj_part_nums;
+  std::size_t rows() const {
+    return words_per_row ? words.size() / words_per_row : 0;
+  }
+
+  std::size_t words_per_row{0};
+  std::vector<std::uint64_t> words;
 };
 
-namespace hash {
+// bits of word w that fall into [begin, end)
+std::uint64_t range_mask(std::size_t w, std::size_t begin, std::size_t end) {
+  auto lo = w * word_bits;
+  auto mask = ~std::uint64_t{0};
+  if (begin > lo) {
+    mask &= mask << (begin - lo);
+  }
+  if (end < lo + word_bits) {
+    mask &= (std::uint64_t{1} << (end - lo)) - 1;
+  }
+  return mask;
+}
 
-inline void hash_combine(std::size_t &seed) {}
+// calls fn(bit) for every set bit of row in [begin, end), bits past the
+// end of the row count as clear
+template <typename Fn>
+void for_each_bit(std::span<std::uint64_t const> row, std::size_t begin,
+                  std::size_t end, Fn &&fn) {
+  end = std::min(end, row.size() * word_bits);
+  for (auto w = begin / word_bits; w * word_bits < end; ++w) {
+    for (auto bits = row[w] & range_mask(w, begin, end); bits != 0;
+         bits &= bits - 1) {
+      fn(w * word_bits + std::countr_zero(bits));
+    }
+  }
+}
 
-template <typename T, typename... Rest>
-inline void hash_combine(std::size_t &seed, const T &v, Rest... rest) {
-  std::hash<T> hasher;
-  seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-  hash_combine(seed, rest...);
+bool any_bit(std::span<std::uint64_t const> row, std::size_t begin,
+             std::size_t end) {
+  end = std::min(end, row.size() * word_bits);
+  for (auto w = begin / word_bits; w * word_bits < end; ++w) {
+    if (row[w] & range_mask(w, begin, end)) {
+      return true;
+    }
+  }
+  return false;
 }
 
-} // namespace hash
+// every cell with a set cell among its 8 neighbours or itself: each row is
+// dilated sideways with shifts, then OR-ed with the rows above and below
+bitmap dilate(bitmap const &src) {
+  auto n = src.words_per_row;
+  bitmap wide = src;
+  for (std::size_t pr = 0; pr < src.rows(); ++pr) {
+    auto in = src.row(pr);
+    auto *out = wide.words.data() + pr * n;
+    for (std::size_t w = 0; w < n; ++w) {
+      auto left = w > 0 ? in[w - 1] >> (word_bits - 1) : 0;
+      auto right = w + 1 < n ? in[w + 1] << (word_bits - 1) : 0;
+      out[w] = in[w] | in[w] << 1 | left | in[w] >> 1 | right;
+    }
+  }
 
-namespace std {
-template <> struct hash<position> {
-  size_t operator()(position const &pos) const {
-    size_t hash = 0;
-    ::hash::hash_combine(hash, pos.x, pos.y);
-    return hash;
+  bitmap near = wide;
+  for (std::size_t pr = 1; pr + 1 < src.rows(); ++pr) {
+    for (std::size_t w = 0; w < n; ++w) {
+      near.words[pr * n + w] |=
+          wide.words[(pr - 1) * n + w] | wide.words[(pr + 1) * n + w];
+    }
   }
+  return near;
+}
+
+// running ratio of one gear
+struct gear {
+  std::uint32_t parts{0};
+  std::uint64_t ratio{1};
 };
 
-} // namespace std
+// Streaming evaluation that only ever holds three rows. A number can be
+// judged once the row below it arrived, and a gear is complete once the
+// numbers of the row below it were judged, so both are settled one and two
+// rows after they were read and their row is then reused for the next line.
+// Rows pushed as not owned only serve as neighbours, their numbers and gears
+// are left to whoever owns them. Without with_gears only part_sum is kept.
+class row_window {
+public:
+  explicit row_window(bool with_gears) : with_gears(with_gears) {}
+
+  void push(std::string_view line, bool owned = true) {
+    auto &row = slot(next_row++);
+    load(row, line);
+    row.owned = owned;
+    if (next_row >= 2) {
+      link_row(next_row - 2);
+    }
+    if (next_row >= 3) {
+      retire(next_row - 3);
+    }
+  }
+
+  // settles the rows still in the window
+  void finish() {
+    if (next_row >= 1) {
+      link_row(next_row - 1);
+    }
+    for (auto r = next_row >= 2 ? next_row - 2 : 0; r < next_row; ++r) {
+      retire(r);
+    }
+  }
 
-int main(int argc, char **argv) {
+  size_t part_sum{0};
+  size_t gear_sum{0};
+
+private:
+  struct row_state {
+    std::string_view line;
+    bool owned{true};
+    // symbols spread one column to either side, padded like bitmap rows
+    std::vector<std::uint64_t> wide;
+    std::vector<std::uint64_t> gear_cells;
+    // gear bits in the words before, and the gears by rank in the row
+    std::vector<std::uint32_t> gear_rank;
+    std::vector<gear> gears;
+  };
 
-  auto args = parse_args(argc, argv);
+  row_state &slot(std::size_t r) { return rows[r % rows.size()]; }
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+  // the row r if it is inside the window
+  row_state *at(std::size_t r, std::ptrdiff_t offset) {
+    auto target = static_cast<std::ptrdiff_t>(r) + offset;
+    if (target < 0 or target >= static_cast<std::ptrdiff_t>(next_row)) {
+      return nullptr;
+    }
+    return &slot(static_cast<std::size_t>(target));
   }
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+  void load(row_state &row, std::string_view line) {
+    auto words = (line.size() + 2 + word_bits - 1) / word_bits;
+    row.line = line;
+    // sized to the line and never shrunk, so steady state does not allocate
+    row.wide.assign(words, 0);
+    row.gear_cells.assign(words, 0);
+    row.gear_rank.resize(words);
+
+    symbols.assign(words, 0);
+    for (std::size_t col = 0; col < line.size(); ++col) {
+      if (is_symbol(line[col])) {
+        auto bit = col + 1;
+        symbols[bit / word_bits] |= std::uint64_t{1} << (bit % word_bits);
+        if (line[col] == '*') {
+          row.gear_cells[bit / word_bits] |= std::uint64_t{1}
+                                             << (bit % word_bits);
+        }
+      }
+    }
+    for (std::size_t w = 0; w < words; ++w) {
+      auto left = w > 0 ? symbols[w - 1] >> (word_bits - 1) : 0;
+      auto right = w + 1 < words ? symbols[w + 1] << (word_bits - 1) : 0;
+      row.wide[w] = symbols[w] | symbols[w] << 1 | left | symbols[w] >> 1 |
+                    right;
+    }
+
+    std::uint32_t total = 0;
+    for (std::size_t w = 0; w < words; ++w) {
+      row.gear_rank[w] = total;
+      total += std::popcount(row.gear_cells[w]);
+    }
+    row.gears.assign(total, gear{});
+  }
+
+  // judges the numbers of row r against the rows around it
+  void link_row(std::size_t r) {
+    std::array<row_state *, 3> around{at(r, -1), at(r, 0), at(r, 1)};
+    auto line = around[1]->line;
+
+    for (std::size_t col = 0; col < line.size(); ++col) {
+      if (!is_digit(line[col])) {
+        continue;
+      }
+      auto [val, digits] = aoc::scan_int<int>(line.substr(col));
+      auto begin = col + 1;
+      auto end = col + 1 + digits;
+      col += digits - 1;
+
+      bool is_part = false;
+      for (auto *row : around) {
+        is_part = is_part or (row and any_bit(row->wide, begin, end));
+      }
+      if (!is_part) {
+        continue;
+      }
+      if (around[1]->owned) {
+        part_sum += val;
+      }
+      if (!with_gears) {
+        continue;
+      }
 
-  ifs.open(path);
+      for (auto *row : around) {
+        if (!row) {
+          continue;
+        }
+        std::span<std::uint64_t const> cells = row->gear_cells;
+        for_each_bit(cells, begin - 1, end + 1, [&](std::size_t bit) {
+          auto w = bit / word_bits;
+          auto below = cells[w] & ((std::uint64_t{1} << (bit % word_bits)) - 1);
+          auto &g = row->gears[row->gear_rank[w] + std::popcount(below)];
+          ++g.parts;
+          g.ratio *= val;
+        });
+      }
+    }
+  }
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+  void retire(std::size_t r) {
+    if (!with_gears or !slot(r).owned) {
+      return;
+    }
+    for (auto const &g : slot(r).gears) {
+      if (g.parts == 2) {
+        gear_sum += g.ratio;
+      }
+    }
   }
 
-  std::size_t acc{};
-  /* std::vector<std::string> schematic; */
+  std::array<row_state, 3> rows;
+  // the symbols of the row being loaded, before they are spread
+  std::vector<std::uint64_t> symbols;
+  std::size_t next_row{0};
+  bool with_gears;
+};
 
-  auto is_digit = [](char c) { return c >= '0' and c <= '9'; };
-  auto is_empty = [](char c) { return c == '.'; };
+struct band_sums {
+  size_t parts{0};
+  size_t gears{0};
+};
 
-  std::unordered_map<position, Symbol> symbols;
+// Streams band, a run of whole lines of input. The lines right above and
+// below it are pushed as halo rows that only provide neighbours, so every
+// number and gear is counted by the one band holding its row and adding the
+// band sums gives exactly the single threaded result.
+band_sums stream_band(std::string_view input, std::string_view band,
+                      bool with_gears) {
+  row_window window(with_gears);
+  auto begin = static_cast<std::size_t>(band.data() - input.data());
+  auto end = begin + band.size();
+
+  if (begin > 0) {
+    // bands start after a '\n'
+    auto above = input.substr(0, begin - 1);
+    above.remove_prefix(above.rfind('\n') + 1);
+    window.push(above, false);
+  }
+  for (std::string_view line : line_range{band}) {
+    window.push(line);
+  }
+  if (end < input.size()) {
+    auto below = input.substr(end);
+    window.push(below.substr(0, below.find('\n')), false);
+  }
+  window.finish();
+  return {window.part_sum, window.gear_sum};
+}
+
+struct solution {
 
-  std::vector<Part> parts;
-  std::string line;
-  int row = 0;
-  while (std::getline(ifs, line)) {
-    for (int col = 0; col < line.size(); ++col) {
+  // --mode stream evaluates through a three row window instead of loading
+  // the whole schematic, for inputs too large to hold as bitmaps. --threads N
+  // streams horizontal bands of the schematic in parallel.
+  explicit solution(args_t const &params)
+      : streaming(option(params, "--mode") == "stream"),
+        pool(aoc::make_pool(params)) {}
 
-      char c = line[col];
-      if (is_digit(c)) {
+  void parse(std::string_view input) {
+    text = input;
+    if (streaming or pool) {
+      return;
+    }
 
-        position orig{row - 1, col - 1};
-        int val = 0;
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    for (std::string_view line : line_range{input}) {
+      cols = std::max(cols, line.size());
+      ++rows;
+    }
 
-        while (col < line.size() and is_digit(line[col])) {
-          val = val * 10 + line[col++] - '0';
+    symbols = bitmap(rows, cols);
+    gear_cells = bitmap(rows, cols);
+    std::size_t row = 0;
+    for (std::string_view line : line_range{input}) {
+      for (std::size_t col = 0; col < line.size(); ++col) {
+        if (is_symbol(line[col])) {
+          symbols.set(row, col);
+          if (line[col] == '*') {
+            gear_cells.set(row, col);
+          }
         }
+      }
+      ++row;
+    }
+    near_symbol = dilate(symbols);
+
+    // gears are numbered by their rank among the set gear bits
+    gear_rank.resize(gear_cells.words.size());
+    gear_count = 0;
+    for (std::size_t w = 0; w < gear_cells.words.size(); ++w) {
+      gear_rank[w] = gear_count;
+      gear_count += std::popcount(gear_cells.words[w]);
+    }
 
-        int width = (col--) - orig.y + 1;
-        parts.push_back({area{orig, width}, val});
+    AOC_COUNT("day3/symbols", count_bits(symbols));
+  }
 
-      } else if (!is_empty(c)) {
-        symbols[{row, col}] = {c == '*'};
-      }
+  size_t part1() const {
+    if (streaming or pool) {
+      AOC_SCOPE("day3/stream_rows");
+      return stream(false).parts;
     }
-    ++row;
+
+    AOC_SCOPE("day3/sum_parts");
+    size_t part_sum = 0;
+    std::size_t parts = 0;
+    for_each_number([&](std::size_t row, std::size_t col, std::size_t digits,
+                        int val) {
+      if (is_part(row, col, digits)) {
+        part_sum += val;
+        ++parts;
+      }
+    });
+    AOC_COUNT("day3/parts", parts);
+    return part_sum;
   }
 
-  auto has_adjacent_symbol = [&symbols](Part const &part) -> bool {
-    // TODO: try to do it with ranges
-    // ranges::views::iota(part.area.origin.y) |
-    // ranges::views::take(part.area.width)
-    //
+  size_t part2() const {
+    if (streaming or pool) {
+      AOC_SCOPE("day3/stream_rows");
+      return stream(true).gears;
+    }
 
-    auto is_part = false;
+    // attach every part to the gears around it
+    AOC_SCOPE("day3/link_gears");
+    std::vector<gear> gears(gear_count);
+    for_each_number([&](std::size_t row, std::size_t col, std::size_t digits,
+                        int val) {
+      if (is_part(row, col, digits)) {
+        link_gears(gears, row, col, digits, val);
+      }
+    });
 
-    for (int i = 0; i < part.area.width; ++i) {
-      for (int j = 0; j < part.area.height; ++j) {
-        if (auto it = symbols.find(
-                position{part.area.origin.x + j, part.area.origin.y + i});
-            it != symbols.end()) {
+    size_t gear_sum = 0;
+    for (auto const &g : gears) {
+      if (g.parts == 2) {
+        gear_sum += g.ratio;
+      }
+    }
+    return gear_sum;
+  }
 
-          if (it->second.is_gear) {
-            auto sym = *it;
-            it->second.adj_part_nums.push_back(part.val);
-          }
+private:
+  band_sums stream(bool with_gears) const {
+    return aoc::parallel_reduce_lines(
+        pool.get(), text, band_sums{},
+        [this, with_gears](std::string_view band) {
+          return stream_band(text, band, with_gears);
+        },
+        [](band_sums acc, band_sums const &band) {
+          acc.parts += band.parts;
+          acc.gears += band.gears;
+          return acc;
+        });
+  }
 
-          is_part = true;
+  // calls fn(row, col, digits, value) for every number of the schematic
+  template <typename Fn> void for_each_number(Fn &&fn) const {
+    std::size_t row = 0;
+    for (std::string_view line : line_range{text}) {
+      for (std::size_t col = 0; col < line.size(); ++col) {
+        if (is_digit(line[col])) {
+          auto [val, digits] = aoc::scan_int<int>(line.substr(col));
+          fn(row, col, digits, val);
+          col += digits - 1;
         }
       }
+      ++row;
     }
-    return is_part;
-  };
+  }
 
-  // part 1
-  size_t sum =
-      ranges::accumulate(parts | ranges::views::filter(has_adjacent_symbol) |
-                             ranges::views::transform(&Part::val),
-                         0);
-
-  // part 2
-  size_t gear_ratio_sum = ranges::accumulate(
-      symbols | ranges::views::values |
-          ranges::views::filter([](Symbol const &sym) {
-            return sym.is_gear and sym.adj_part_nums.size() == 2;
-          }) |
-          ranges::views::transform([](auto const &sym) {
-            return sym.adj_part_nums[0] * sym.adj_part_nums[1];
-          }),
-      0);
-
-  fmt::println("sum of all part numbers {}", sum);
-  fmt::println("sum of all gear ratios {}", gear_ratio_sum);
-
-  return 0;
-}
+  // the number at (row, col) with `digits` digits, in padded coordinates it
+  // covers bits col + 1 .. col + digits of row + 1, its neighbourhood bits
+  // col .. col + digits + 1 of the three rows around
+  bool is_part(std::size_t row, std::size_t col, std::size_t digits) const {
+    return any_bit(near_symbol.row(row + 1), col + 1, col + 1 + digits);
+  }
+
+  void link_gears(std::vector<gear> &gears, std::size_t row, std::size_t col,
+                  std::size_t digits, int val) const {
+    auto pr = row + 1;
+    for (auto r = pr - 1; r <= pr + 1; ++r) {
+      auto cells = gear_cells.row(r);
+      for_each_bit(cells, col, col + digits + 2, [&](std::size_t bit) {
+        auto w = bit / word_bits;
+        auto below = cells[w] & ((std::uint64_t{1} << (bit % word_bits)) - 1);
+        auto &g = gears[gear_rank[r * gear_cells.words_per_row + w] +
+                        std::popcount(below)];
+        ++g.parts;
+        g.ratio *= val;
+      });
+    }
+  }
+
+  static std::size_t count_bits(bitmap const &bits) {
+    std::size_t count = 0;
+    for (auto word : bits.words) {
+      count += std::popcount(word);
+    }
+    return count;
+  }
+
+  bitmap symbols;
+  bitmap gear_cells;
+  bitmap near_symbol;
+  // gear bits in the words before, per word of gear_cells
+  std::vector<std::uint32_t> gear_rank;
+  std::uint32_t gear_count{0};
+  std::string_view text;
+  bool streaming{false};
+  std::unique_ptr<aoc::thread_pool> pool;
+};
+
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day3_task1", "day3/input.txt");
+
+} // namespace
@@ -1,100 +1,301 @@
 #include "args.hpp"
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
+#include "tokenizer.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
-#include <range/v3/all.hpp>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
-#include <unordered_set>
+#include <vector>
 
-int main(int argc, char **argv) {
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
-  auto args = parse_args(argc, argv);
+namespace {
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+int calc_points(int len) {
+  if (len == 0) {
+    return 0;
   }
+  return 0x1 << (len - 1);
+}
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+// one side of a card as a set of the numbers below 128, the puzzle's cards
+// have nothing larger so `large` stays false outside of odd inputs
+struct number_set {
+  std::array<std::uint64_t, 2> bits{};
+  bool large{false};
+};
 
-  ifs.open(path);
+number_set read_numbers(std::string_view side) {
+  number_set set;
+  for (std::string_view token : aoc::tokenize(side)) {
+    auto number = aoc::parse_int<unsigned>(token);
+    if (number < 128) {
+      set.bits[number / 64] |= std::uint64_t{1} << (number % 64);
+    } else {
+      set.large = true;
+    }
+  }
+  return set;
+}
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+// matches among the numbers >= 128, which the bit sets leave out
+int large_matches(std::string_view winning, std::string_view mine) {
+  int hits = 0;
+  for (std::string_view token : aoc::tokenize(mine)) {
+    auto number = aoc::parse_int<unsigned>(token);
+    if (number < 128) {
+      continue;
+    }
+    for (std::string_view other : aoc::tokenize(winning)) {
+      if (aoc::parse_int<unsigned>(other) == number) {
+        ++hits;
+        break;
+      }
+    }
   }
+  return hits;
+}
 
-  std::size_t acc{};
+// out[i] += popcount(winning[i] & mine[i]), with AVX2 two cards per register
+// and the bytes counted through a nibble lookup table
+void count_matches(std::span<std::array<std::uint64_t, 2> const> winning,
+                   std::span<std::array<std::uint64_t, 2> const> mine,
+                   std::span<int> out) {
+  std::size_t idx = 0;
+#ifdef __AVX2__
+  auto const nibbles = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                        3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                        2, 3, 2, 3, 3, 4);
+  auto const low = _mm256_set1_epi8(0x0f);
+  for (; idx + 2 <= out.size(); idx += 2) {
+    auto w = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const *>(winning.data() + idx));
+    auto m = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const *>(mine.data() + idx));
+    auto both = _mm256_and_si256(w, m);
+    auto bytes = _mm256_add_epi8(
+        _mm256_shuffle_epi8(nibbles, _mm256_and_si256(both, low)),
+        _mm256_shuffle_epi8(nibbles,
+                            _mm256_and_si256(_mm256_srli_epi16(both, 4), low)));
+    // one count per 64 bit lane, two lanes per card
+    alignas(32) std::array<std::uint64_t, 4> lanes;
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()),
+                       _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    out[idx] += static_cast<int>(lanes[0] + lanes[1]);
+    out[idx + 1] += static_cast<int>(lanes[2] + lanes[3]);
+  }
+#endif
+  for (; idx < out.size(); ++idx) {
+    out[idx] += std::popcount(winning[idx][0] & mine[idx][0]) +
+                std::popcount(winning[idx][1] & mine[idx][1]);
+  }
+}
 
-  using card_id = int;
-  std::vector<std::size_t> points;
-  std::unordered_map<card_id, int> copies;
+// winning numbers found on each card of a run of lines, out has one slot
+// per line
+void card_matches(std::string_view lines, std::span<int> out) {
+  std::vector<std::array<std::uint64_t, 2>> winning_sets;
+  std::vector<std::array<std::uint64_t, 2>> my_sets;
+  winning_sets.reserve(out.size());
+  my_sets.reserve(out.size());
 
-  std::string line;
-  while (std::getline(ifs, line)) {
+  auto slot = out.begin();
+  for (std::string_view line : line_range{lines}) {
+    auto card = aoc::split_once(line, ':').second;
+    auto [winning, mine] = aoc::split_once(card, '|');
 
-    std::unordered_set<int> numbers;
+    auto winning_set = read_numbers(winning);
+    auto my_set = read_numbers(mine);
+    winning_sets.push_back(winning_set.bits);
+    my_sets.push_back(my_set.bits);
+    *slot++ = winning_set.large and my_set.large ? large_matches(winning, mine)
+                                                 : 0;
+  }
 
-    line = line | ranges::views::split(':') | ranges::views::drop(1) |
-           ranges::views::join | ranges::to<std::string>();
+  count_matches(winning_sets, my_sets, out);
+}
 
-    auto l = ranges::views::transform(
-        line | ranges::views::split('|'),
-        [](auto &&rng) { return rng | ranges::views::split(' '); });
+// lines as line_range counts them, a last line needs no '\n'
+std::size_t line_count(std::string_view lines) {
+  auto count = static_cast<std::size_t>(std::ranges::count(lines, '\n'));
+  return count + (!lines.empty() and lines.back() != '\n');
+}
 
-    auto not_empty = [](auto &&rng) { return ranges::distance(rng) > 0; };
-    auto str_rng_to_int = [](auto &&str_rng) {
-      auto str = str_rng | ranges::to<std::string>();
-      return std::stoi(str);
-    };
+// winning numbers found on a single card, for the streaming mode
+int match_count(std::string_view line) {
+  auto card = aoc::split_once(line, ':').second;
+  auto [winning, mine] = aoc::split_once(card, '|');
 
-    auto add_number = [&](int number) { numbers.insert(number); };
+  auto winning_set = read_numbers(winning);
+  auto my_set = read_numbers(mine);
+  int hits = std::popcount(winning_set.bits[0] & my_set.bits[0]) +
+             std::popcount(winning_set.bits[1] & my_set.bits[1]);
+  if (winning_set.large and my_set.large) {
+    hits += large_matches(winning, mine);
+  }
+  return hits;
+}
 
-    ranges::for_each(l | ranges::views::take(1) | ranges::views::join |
-                         ranges::views::filter(not_empty) |
-                         ranges::views::transform(str_rng_to_int),
-                     add_number);
+// Copies held of every card, fed one card at a time. A card hands its copies
+// to the next `matches` cards only, so the pending copies are a difference
+// array over a ring a little wider than the largest match count: constant
+// memory and O(1) per card however many cards there are.
+//
+// Copies double with every winning card, so a long enough input outgrows any
+// counter. The ring counts in 128 bits, where the running sum of the at most
+// ring size cards handing out copies is exact, and a card or total past 64
+// bits throws instead of wrapping.
+class copy_cascade {
+public:
+  explicit copy_cascade(std::size_t max_matches = 0) { fit(max_matches); }
 
-    auto is_my_number = [&](int number) { return numbers.contains(number); };
+  // copies of the next card, which wins `matches` cards after it
+  std::uint64_t push(std::size_t matches) {
+    fit(matches);
+    auto &here = pending[card & mask()];
+    running += here;
+    here = 0;
+    wide copies = 1 + running;
+    if (copies > std::numeric_limits<std::uint64_t>::max() or
+        __builtin_add_overflow(total, static_cast<std::uint64_t>(copies),
+                               &total)) {
+      throw std::overflow_error(
+          fmt::format("day4: copies of card {} exceed 64 bits", card + 1));
+    }
+    if (matches != 0) {
+      // the difference array may dip below zero modulo 2^128, running may not
+      pending[(card + 1) & mask()] += copies;
+      pending[(card + matches + 1) & mask()] -= copies;
+    }
+    ++card;
+    return static_cast<std::uint64_t>(copies);
+  }
 
-    auto hits = l | ranges::views::drop(1) | ranges::views::take(1) |
-                ranges::views::join | ranges::views::filter(not_empty) |
-                ranges::views::transform(str_rng_to_int) |
-                ranges::views::filter(is_my_number);
+  std::uint64_t cards() const { return total; }
 
-    auto calc_points = [](int len) {
-      if (len == 0) {
-        return 0;
-      }
-      return 0x1 << (len - 1);
-    };
+private:
+  std::size_t mask() const { return pending.size() - 1; }
 
-    int amount = ranges::distance(hits);
-    int card_points = calc_points(amount);
+  // the ring has to cover card + matches + 1, grown when a card wins more
+  void fit(std::size_t matches) {
+    if (matches + 2 <= pending.size()) {
+      return;
+    }
+    std::vector<wide> wider(std::bit_ceil(matches + 2), 0);
+    for (std::size_t k = 0; k < pending.size(); ++k) {
+      wider[(card + k) & (wider.size() - 1)] = pending[(card + k) & mask()];
+    }
+    pending = std::move(wider);
+  }
 
-    // part 1
-    acc += card_points;
+  using wide = unsigned __int128;
 
-    // part 2
-    card_id id = points.size();
-    copies[id] += 1;
-    int copies_of_this = copies[id];
-    points.push_back(card_points * copies_of_this);
+  std::vector<wide> pending;
+  wide running{0};
+  std::uint64_t total{0};
+  std::size_t card{0};
+};
 
-    fmt::println("{} matching for card {} which has {} copies", amount, id,
-                 copies[id]);
-    for (int idx{1}; idx <= amount; ++idx) {
-      copies[id + idx] += copies_of_this;
-      fmt::println("{} copies of card {}", copies[id + idx], id + idx);
+struct solution {
+
+  // --mode stream matches the cards again in each part and keeps nothing per
+  // card, --threads N matches the cards in parallel otherwise
+  explicit solution(args_t const &params)
+      : streaming(option(params, "--mode") == "stream"),
+        pool(aoc::make_pool(params)) {}
+
+  void parse(std::string_view input) {
+    if (streaming) {
+      text = input;
+      return;
     }
+
+    // stage one: every chunk counts its cards, a prefix sum over the
+    // counts places the chunks in one array and the chunks then fill their
+    // slices of it in parallel
+    AOC_SCOPE("day4/match_cards");
+    auto chunks = aoc::split_lines(input, pool ? pool->size() * 4 : 1);
+    std::vector<std::size_t> offsets(chunks.size() + 1, 0);
+    aoc::parallel_for(pool.get(), chunks.size(), [&](std::size_t i) {
+      offsets[i + 1] = line_count(chunks[i]);
+    });
+    std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+    matches.assign(offsets.back(), 0);
+    aoc::parallel_for(pool.get(), chunks.size(), [&](std::size_t i) {
+      card_matches(chunks[i], std::span(matches).subspan(
+                                  offsets[i], offsets[i + 1] - offsets[i]));
+    });
   }
 
-  std::size_t after_copies =
-      ranges::accumulate(copies | ranges::views::values, 0);
-  fmt::println("has {} points", acc);
-  fmt::println("with copies has {} points", after_copies);
+  std::size_t part1() const {
+    if (streaming) {
+      AOC_SCOPE("day4/stream_cards");
+      std::size_t points = 0;
+      for (std::string_view line : line_range{text}) {
+        points += calc_points(match_count(line));
+      }
+      return points;
+    }
+    auto points_sum = [this](std::size_t begin, std::size_t end) {
+      std::size_t acc{};
+      for (auto idx = begin; idx < end; ++idx) {
+        acc += calc_points(matches[idx]);
+      }
+      return acc;
+    };
+    return aoc::parallel_reduce(pool.get(), matches.size(), std::size_t{0},
+                                points_sum, std::plus<>{});
+  }
 
-  return 0;
-}
+  std::uint64_t part2() const {
+    if (streaming) {
+      AOC_SCOPE("day4/stream_cards");
+      copy_cascade cascade;
+      for (std::string_view line : line_range{text}) {
+        cascade.push(match_count(line));
+      }
+      return cascade.cards();
+    }
+    // stage two: the cascade only looks back a few cards, one sequential
+    // pass over the match array
+    AOC_SCOPE("day4/copy_cards");
+
+    copy_cascade cascade(matches.empty() ? 0 : std::ranges::max(matches));
+    for (std::size_t id = 0; id < matches.size(); ++id) {
+      auto copies = cascade.push(matches[id]);
+      AOC_TRACE("{} matching for card {} which has {} copies", matches[id], id,
+                copies);
+    }
+    return cascade.cards();
+  }
+
+  bool streaming{false};
+  // the cards, only kept with --mode stream which matches them in the parts
+  std::string_view text;
+  // winning numbers found on each card, in card order
+  std::vector<int> matches;
+  std::unique_ptr<aoc::thread_pool> pool;
+};
+
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day4", "day4/input.txt");
+
+} // namespace
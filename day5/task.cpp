@@ -1,48 +1,42 @@
-#include "args.hpp"
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "piecewise_map.hpp"
+#include "solver.hpp"
+#include "tokenizer.hpp"
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
+#include <limits>
 #include <range/v3/all.hpp>
+#include <string>
+#include <stdexcept>
 #include <string_view>
-#include <unordered_set>
 #include <vector>
 
+namespace {
+
+using value_t = aoc::piecewise_map::value_t;
+
+// One almanac stage, its rules are only collected here and turned into a
+// piecewise map for composing. Rules are assumed not to overlap, as in the
+// puzzle.
 struct mapping {
 
   void add_rule(size_t to, size_t from, size_t len) {
-    rules.push_back({to, from, len});
+    rules.push_back({static_cast<value_t>(to), static_cast<value_t>(from),
+                     static_cast<value_t>(len)});
   }
 
-  size_t operator()(size_t from) const {
-
-    for (auto const &rule : rules) {
-      // fmt::println("num: {} rule: <{}, {}> to <{},{}>", from, rule.from,
-      // rule.from + rule.len, rule.to, rule.to + rule.len);
-      size_t offset = from - rule.from;
-      if (offset >= 0 and offset < rule.len) {
-        return rule.to + offset;
-      }
-    }
-    return from;
+  aoc::piecewise_map as_piecewise() const {
+    return aoc::piecewise_map::from_rules(rules);
   }
 
 private:
-  struct map_rule {
-    size_t to;
-    size_t from;
-    size_t len;
-  };
-
-  std::vector<map_rule> rules;
-};
-
-auto split_strs = [](auto &&pattern) {
-  using namespace ranges;
-  return views::split(pattern) | views::transform([](auto p) {
-           auto c = p | views::common;
-           return std::string(c.begin(), c.end());
-         });
+  std::vector<aoc::piecewise_map::rule> rules;
 };
 
 struct almanac_parser {
@@ -52,8 +46,7 @@ struct almanac_parser {
     if (!lines) {
       parse_seeds(line);
     } else if (line.empty() && parsing_context) {
-      mappings.push_back(*parsing_context);
-      parsing_context.reset();
+      close_mapping();
     } else {
       auto label = std::string(":pam");
       if (ranges::all_of(
@@ -65,15 +58,15 @@ struct almanac_parser {
 
       } else {
         // numbers
-        auto rule_bounds = line | split_strs(' ') |
-                           ranges::views::transform([](std::string const &str) {
-                             return std::stol(str);
-                           }) |
-                           ranges::to<std::vector<size_t>>;
-        assert(parsing_context);
-        assert(rule_bounds.size() == 3);
-        parsing_context->add_rule(rule_bounds[0], rule_bounds[1],
-                                  rule_bounds[2]);
+        std::array<size_t, 3> rule{};
+        auto found = aoc::parse_ints<size_t>(line, rule);
+        if (!parsing_context or found != rule.size()) {
+          throw std::runtime_error(
+              fmt::format("almanac line {}: expected <to> <from> <length> "
+                          "inside a map, got '{}'",
+                          lines + 1, line));
+        }
+        parsing_context->add_rule(rule[0], rule[1], rule[2]);
       }
     }
 
@@ -81,13 +74,19 @@ struct almanac_parser {
   }
 
   void parse_seeds(std::string_view line) {
+    seeds = aoc::parse_ints<size_t>(aoc::split_once(line, ':').second);
+  }
 
-    using namespace std::literals::string_view_literals;
+  // the last map is not followed by an empty line
+  void finish() {
+    if (parsing_context) {
+      close_mapping();
+    }
+  }
 
-    seeds = line | ranges::views::drop(("seeds: "sv).size()) | split_strs(' ') |
-            ranges::views::transform(
-                [](std::string const &str) { return std::stol(str); }) |
-            ranges::to<std::vector<size_t>>;
+  void close_mapping() {
+    mappings.push_back(std::move(*parsing_context));
+    parsing_context.reset();
   }
 
   std::vector<mapping> get_mappings() const { return mappings; }
@@ -99,76 +98,72 @@ struct almanac_parser {
   std::optional<mapping> parsing_context;
 };
 
-int main(int argc, char **argv) {
 
-  auto args = parse_args(argc, argv);
+struct solution {
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
-  }
+  void parse(std::string_view input) {
+    {
+      AOC_SCOPE("day5/parse_almanac");
+      almanac_parser parser;
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+      for (std::string_view line : line_range{input}) {
+        parser(line);
+      }
+      parser.finish();
 
-  ifs.open(path);
+      seeds = parser.get_seeds();
+      mappings = parser.get_mappings();
+    }
+    AOC_DEBUG("seeds: {}", seeds);
+    AOC_DEBUG("mappings amount: {}", mappings.size());
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+    // every stage folded into one table, shared by both parts
+    AOC_SCOPE("day5/compose_mappings");
+    seed_to_location = {};
+    for (auto const &map : mappings) {
+      AOC_SCOPE("day5/compose_stage");
+      seed_to_location = seed_to_location.then(map.as_piecewise());
+      AOC_COUNT("day5/stage_pieces", seed_to_location.size());
+    }
+    AOC_COUNT("day5/composed_pieces", seed_to_location.size());
   }
 
-  almanac_parser parser;
-
-  std::string line;
-  while (std::getline(ifs, line)) {
-    parser(line);
-    /* fmt::println("{}", line); */
+  size_t part1() const {
+    AOC_SCOPE("day5/locate_seeds");
+    auto nearest = std::numeric_limits<size_t>::max();
+    for (size_t seed : seeds) {
+      auto location =
+          static_cast<size_t>(seed_to_location(static_cast<value_t>(seed)));
+      AOC_TRACE("{} -> {}", seed, location);
+      nearest = std::min(nearest, location);
+    }
+    return nearest;
   }
 
-  auto seeds = parser.get_seeds();
-  auto mappings = parser.get_mappings();
-  fmt::println("seeds: {}", seeds);
-  fmt::println("mappings amount: {}", mappings.size());
-
-  auto locations = ranges::views::transform(seeds, [&mappings](size_t seed) {
-    for (auto const &map : mappings) {
-
-      auto transformed = map(seed);
-      fmt::println("{} -> {}", seed, transformed);
-      seed = transformed;
+  // seeds are <start> <length> pairs, each range costs one search plus the
+  // composed pieces inside it instead of a walk over every seed
+  size_t part2() const {
+    AOC_SCOPE("day5/locate_seed_ranges");
+    auto nearest = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i + 1 < seeds.size(); i += 2) {
+      if (seeds[i + 1] == 0) {
+        continue;
+      }
+      auto first = static_cast<value_t>(seeds[i]);
+      auto last = first + static_cast<value_t>(seeds[i + 1]) - 1;
+      auto location = seed_to_location.min_image(first, last);
+      AOC_COUNT("day5/seed_ranges", 1);
+      nearest = std::min(nearest, static_cast<size_t>(location));
     }
-    fmt::println("----");
-    return seed;
-  });
-  size_t min_location = ranges::min(locations);
-
-  fmt::println("part1 closest location: {}", min_location);
-
-  // part 2
-  {
-    using namespace ranges;
-    auto seed_gen =
-        seeds | views::chunk(2) | views::transform([](auto seed_rng) {
-          auto seed_bounds = seed_rng | to_vector;
-          return views::iota(seed_bounds[0]) | views::take(seed_bounds[1]);
-        }) |
-        views::join;
-    auto locations =
-        ranges::views::transform(seed_gen, [&mappings](size_t seed) {
-          for (auto const &map : mappings) {
-
-            auto transformed = map(seed);
-            /* fmt::println("{} -> {}", seed, transformed); */
-            seed = transformed;
-          }
-          /* fmt::println("----"); */
-          return seed;
-        });
-    size_t min_location = ranges::min(locations);
-    fmt::println("part2 closest location: {}", min_location);
+    return nearest;
   }
 
-  return 0;
-}
+  std::vector<size_t> seeds;
+  std::vector<mapping> mappings;
+  aoc::piecewise_map seed_to_location;
+};
+
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day5", "day5/input.txt");
+
+} // namespace
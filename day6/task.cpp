@@ -1,13 +1,19 @@
-#include "args.hpp"
+#include "instrument.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "solver.hpp"
+#include "tokenizer.hpp"
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <range/v3/all.hpp>
+#include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
 
+namespace {
+
 namespace day6 {
 
 struct race_info {
@@ -16,87 +22,72 @@ struct race_info {
 };
 } // namespace day6
 
-auto split_strs = [](auto &&pattern) {
-  using namespace ranges;
-  return views::split(pattern) | views::transform([](auto p) {
-           auto c = p | views::common;
-           return std::string(c.begin(), c.end());
-         });
-};
-
-int main(int argc, char **argv) {
-
-  auto args = parse_args(argc, argv);
+// the digits of a line read as a single number, "Time:  7  15" -> 715
+size_t concat_digits(std::string_view line) {
+  size_t val = 0;
+  for (char c : line) {
+    if (c >= '0' and c <= '9') {
+      val = val * 10 + (c - '0');
+    }
+  }
+  return val;
+}
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+size_t calc_win_variants(day6::race_info ri) {
+  size_t cnt = 0;
+  for (int i = 1; i <= ri.time; ++i) {
+    size_t const speed = i;
+    size_t const time = ri.time - i;
+    if (time * speed > ri.record) {
+      ++cnt;
+    }
   }
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+  return cnt;
+}
 
-  ifs.open(path);
+struct solution {
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
-  }
+  void parse(std::string_view input) {
+    auto lines = line_range{input};
+    auto line_it = lines.begin();
 
-  std::string time_line;
-  std::string dist_line;
-  std::getline(ifs, time_line);
-  std::getline(ifs, dist_line);
-
-  using namespace ranges;
-  using namespace ranges::views;
-
-  auto calc_win_variants = [](day6::race_info ri) {
-    size_t cnt = 0;
-    for (int i = 1; i <= ri.time; ++i) {
-      size_t const speed = i;
-      size_t const time = ri.time - i;
-      if (time * speed > ri.record) {
-        ++cnt;
-      }
+    if (line_it != lines.end()) {
+      time_line = *line_it++;
+    }
+    if (line_it != lines.end()) {
+      dist_line = *line_it++;
     }
+  }
 
-    return cnt;
-  };
+  size_t part1() const {
+    AOC_SCOPE("day6/races");
+    using namespace ranges;
+    using namespace ranges::views;
 
-  // part 1
-  {
-    auto races = zip(time_line | split_strs(' ') | filter(&std::string::size),
-                     dist_line | split_strs(' ') | filter(&std::string::size)) |
+    auto races = zip(aoc::tokenize(time_line), aoc::tokenize(dist_line)) |
                  drop(1) | views::transform([](auto tup) {
-                   auto time = std::stoull(std::get<0>(tup));
-                   auto dist = std::stoull(std::get<1>(tup));
+                   auto time = aoc::parse_int<size_t>(std::get<0>(tup));
+                   auto dist = aoc::parse_int<size_t>(std::get<1>(tup));
                    return day6::race_info{time, dist};
                  }) |
                  views::transform(calc_win_variants);
 
-    size_t ans = fold_left(races, 1, [](size_t l, size_t r) { return l * r; });
-
-    fmt::println("part1: {}", ans);
+    return fold_left(races, size_t{1},
+                     [](size_t l, size_t r) { return l * r; });
   }
 
-  // part 2
-  {
-
-    auto races = zip(time_line | filter(isnumber) | split_strs('\n'),
-                     dist_line | filter(isnumber) | split_strs('\n')) |
-                 views::transform([](auto tup) {
-                   size_t time = std::stoull(std::get<0>(tup));
-                   size_t dist = std::stoull(std::get<1>(tup));
-                   return day6::race_info{time, dist};
-                 }) |
-                 views::transform(calc_win_variants);
+  size_t part2() const {
+    AOC_SCOPE("day6/single_race");
+    return calc_win_variants(
+        day6::race_info{concat_digits(time_line), concat_digits(dist_line)});
+  }
 
-    size_t ans = fold_left(races, 1, [](size_t l, size_t r) { return l * r; });
+  std::string_view time_line;
+  std::string_view dist_line;
+};
 
-    fmt::println("part2: {}", ans);
-  }
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day6", "day6/input.txt");
 
-  return 0;
-}
+} // namespace
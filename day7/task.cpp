@@ -1,18 +1,24 @@
-#include "args.hpp"
-#include "range_split_strs.hpp"
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "solver.hpp"
+#include "tokenizer.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <functional>
 #include <iterator>
 #include <map>
 #include <range/v3/all.hpp>
+#include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
 
+namespace {
+
 namespace day7 {
 
 enum hand_type {
@@ -109,8 +115,7 @@ hand make_hand(std::string const &cards) {
     break;
   }
 
-  fmt::println("hand {} of type {}, counts {}", cards, type_names.at(type),
-               cnt);
+  AOC_TRACE("hand {} of type {}, counts {}", cards, type_names.at(type), cnt);
 
   return hand(cards, type);
 }
@@ -157,58 +162,50 @@ hand make_hand_with_jokers(std::string const &cards) {
     break;
   }
 
-  fmt::println("hand {} of type {}, counts {}", cards, type_names.at(type),
-               cnt);
+  AOC_TRACE("hand {} of type {}, counts {}", cards, type_names.at(type), cnt);
 
   return hand(cards, type);
 }
 
 } // namespace day7
 
-int main(int argc, char **argv) {
+struct solution {
 
-  auto args = parse_args(argc, argv);
+  void parse(std::string_view input) {
+    AOC_SCOPE("day7/rank_hands");
+    for (std::string_view line : line_range{input}) {
+      auto [cards, bid] = aoc::first_tokens<2>(line);
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+      ranking[day7::make_hand_with_jokers(std::string(cards))] =
+          aoc::parse_int<int>(bid);
+    }
   }
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+  // hands are built and ordered with jokers, which is the second half of
+  // the puzzle
+  size_t part2() const {
+    AOC_SCOPE("day7/winnings");
+    using namespace ranges;
 
-  ifs.open(path);
+    if constexpr (aoc::log::compiled(aoc::log::level::trace)) {
+      for_each(ranking, [](auto const &rank) {
+        AOC_TRACE("hand {}", rank.first.show());
+      });
+    }
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+    return accumulate(views::zip(views::iota(1), ranking | views::values) |
+                          views::transform([](auto const &rank_item) {
+                            auto [rank, score] = rank_item;
+                            AOC_TRACE("rank {} score {}", rank, score);
+                            return rank * score;
+                          }),
+                      size_t{0});
   }
 
   std::map<day7::hand, int> ranking;
-  std::string line;
-  while (std::getline(ifs, line)) {
-    auto input = line | split_strs(' ') | ranges::to_vector;
-
-    ranking[day7::make_hand_with_jokers(input[0])] = std::stoi(input[1]);
-  }
-
-  using namespace ranges;
-
-  for_each(ranking, [](auto const &rank) {
-    fmt::println("hand {}", rank.first.show());
-  });
+};
 
-  // part 1
-  size_t score =
-      accumulate(views::zip(views::iota(1), ranking | views::values) |
-                     views::transform([](auto const &rank_item) {
-                       auto [rank, score] = rank_item;
-                       fmt::println("rank {} score {}", rank, score);
-                       return rank * score;
-                     }),
-                 0);
-  fmt::println("score: {}", score);
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day7", "day7/input.txt");
 
-  return 0;
-}
+} // namespace
@@ -1,11 +1,13 @@
-#include "args.hpp"
-#include "range_split_strs.hpp"
-#include <_ctype.h>
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "solver.hpp"
+#include "tokenizer.hpp"
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <functional>
 #include <iterator>
 #include <map>
@@ -15,6 +17,8 @@
 #include <unordered_set>
 #include <vector>
 
+namespace {
+
 namespace day8 {
 
 using node = std::string;
@@ -57,7 +61,7 @@ struct graph {
 
 node left_of(graph const &g, node const &n) {
   if (!g.adj_list.contains(n)) {
-    fmt::println("oops! {} not in graph {}", n, g.adj_list);
+    AOC_ERROR("oops! {} not in graph {}", n, g.adj_list);
     assert(false);
   }
   return g.adj_list.at(n).first;
@@ -71,90 +75,79 @@ node right_of(graph const &g, node const &n) {
 
 } // namespace day8
 
-int main(int argc, char **argv) {
-
-  auto args = parse_args(argc, argv);
-
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
-  }
-
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
-
-  ifs.open(path);
+struct solution {
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
-  }
-
-  std::string line;
-
-  std::string branches;
-  std::getline(ifs, branches);
+  void parse(std::string_view input) {
+    AOC_SCOPE("day8/build_graph");
+    auto lines = line_range{input};
+    auto line_it = lines.begin();
 
-  auto parse_vertex = []() {};
-
-  day8::graph::graph g;
+    if (line_it != lines.end()) {
+      branches = *line_it++;
+    }
 
-  std::vector<day8::node> starting_nodes;
+    for (; line_it != lines.end(); ++line_it) {
+      std::string_view line = *line_it;
+      if (line.empty()) {
+        continue;
+      }
 
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
-      continue;
-    }
+      // "AAA = (BBB, CCC)", generated networks use longer names
+      auto [name, left, right] = aoc::first_tokens<3>(line, " =(),");
 
-    auto letters =
-        line | ranges::views::filter([](char c) { return isupper(c) != 0; }) |
-        ranges::views::chunk(3) | ranges::views::transform([](auto &&rng) {
-          return rng | ranges::to<std::string>;
-        }) |
-        ranges::to_vector;
+      g.add_node(day8::node(name), day8::node(left), day8::node(right));
 
-    g.add_node(letters[0], letters[1], letters[2]);
+      if (name.ends_with('A')) {
+        starting_nodes.emplace_back(name);
+        AOC_DEBUG(" start from: {}", name);
+      }
 
-    if (letters[0].ends_with('A')) {
-      starting_nodes.push_back(letters[0]);
-      fmt::println(" start from: {}", letters[0]);
+      AOC_TRACE("{} {} {}", name, left, right);
     }
-
-    fmt::println("{}", letters);
   }
 
-  size_t hops = 0;
+  size_t part2() const {
+    size_t hops = 0;
+
+    auto next_of = [&hops, this](day8::node const &n) {
+      return branches[hops % branches.size()] == 'L' ? left_of(g, n)
+                                                     : right_of(g, n);
+    };
+
+    auto is_done = [](auto const &nodes) {
+      return ranges::all_of(
+          nodes, [](auto const &node) { return node.ends_with('Z'); });
+    };
+
+    // part1
+    /*
+    day8::node iter = "AAA";
+    while (iter != "ZZZ") {
+      iter = next_of(iter);
+      ++hops;
+    }
+    fmt::println("part1 {} hops!", hops);
+    */
 
-  auto next_of = [&hops, &branches, &g](day8::node const &n) {
-    return branches[hops % branches.size()] == 'L' ? left_of(g, n)
-                                                   : right_of(g, n);
-  };
+    AOC_SCOPE("day8/walk");
+    auto nodes = starting_nodes;
+    while (!is_done(nodes)) {
 
-  auto is_done = [](auto const &nodes) {
-    return ranges::all_of(nodes,
-                          [](auto const &node) { return node.ends_with('Z'); });
-  };
+      ranges::for_each(nodes, [&](auto &node) { node = next_of(node); });
+      /* iter = next_of(iter); */
+      ++hops;
+    }
+    AOC_COUNT("day8/node_lookups", hops * nodes.size());
 
-  // part1
-  /*
-  day8::node iter = "AAA";
-  while (iter != "ZZZ") {
-    iter = next_of(iter);
-    ++hops;
+    return hops;
   }
-  fmt::println("part1 {} hops!", hops);
-  */
 
-  hops = 0;
-  // part2
-  while (!is_done(starting_nodes)) {
+  std::string_view branches;
+  day8::graph::graph g;
+  std::vector<day8::node> starting_nodes;
+};
 
-    ranges::for_each(starting_nodes, [&](auto &node) { node = next_of(node); });
-    /* iter = next_of(iter); */
-    ++hops;
-  }
-  fmt::println("part2 {} hops!", hops);
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day8", "day8/input.txt");
 
-  return 0;
-}
+} // namespace
@@ -1,11 +1,13 @@
-#include "args.hpp"
-#include "range_split_strs.hpp"
-#include <_ctype.h>
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "solver.hpp"
+#include "tokenizer.hpp"
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <functional>
 #include <iterator>
 #include <map>
@@ -16,6 +18,8 @@
 #include <unordered_set>
 #include <vector>
 
+namespace {
+
 namespace day8 {
 
 using node = std::string;
@@ -33,7 +37,7 @@ struct graph {
 
 node left_of(graph const &g, node const &n) {
   if (!g.adj_list.contains(n)) {
-    fmt::println("oops! {} not in graph {}", n, g.adj_list);
+    AOC_ERROR("oops! {} not in graph {}", n, g.adj_list);
     assert(false);
   }
   return g.adj_list.at(n).first;
@@ -47,79 +51,66 @@ node right_of(graph const &g, node const &n) {
 
 } // namespace day8
 
-int main(int argc, char **argv) {
-
-  auto args = parse_args(argc, argv);
-
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
-  }
-
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
-
-  ifs.open(path);
-
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
-  }
-
-  std::string line;
-
-  std::string branches;
-  std::getline(ifs, branches);
-
-  auto parse_vertex = []() {};
+struct solution {
 
-  day8::graph::graph g;
-
-  std::vector<day8::node> starting_nodes;
+  void parse(std::string_view input) {
+    AOC_SCOPE("day8_part2/build_graph");
+    auto lines = line_range{input};
+    auto line_it = lines.begin();
 
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
-      continue;
+    if (line_it != lines.end()) {
+      branches = *line_it++;
     }
 
-    auto letters =
-        line | ranges::views::filter([](char c) { return isupper(c) != 0; }) |
-        ranges::views::chunk(3) | ranges::views::transform([](auto &&rng) {
-          return rng | ranges::to<std::string>;
-        }) |
-        ranges::to_vector;
+    for (; line_it != lines.end(); ++line_it) {
+      std::string_view line = *line_it;
+      if (line.empty()) {
+        continue;
+      }
 
-    g.add_node(letters[0], letters[1], letters[2]);
+      // "AAA = (BBB, CCC)", generated networks use longer names
+      auto [name, left, right] = aoc::first_tokens<3>(line, " =(),");
 
-    if (letters[0].ends_with('A')) {
-      starting_nodes.push_back(letters[0]);
+      g.add_node(day8::node(name), day8::node(left), day8::node(right));
+
+      if (name.ends_with('A')) {
+        starting_nodes.emplace_back(name);
+      }
     }
   }
 
-  auto calc_hops = [&](day8::node iter) {
-    size_t hops = 0;
-    auto next_of = [&hops, &branches, &g](day8::node const &n) {
-      return branches[hops % branches.size()] == 'L' ? left_of(g, n)
-                                                     : right_of(g, n);
+  size_t part2() const {
+    auto calc_hops = [this](day8::node const &from) {
+      AOC_SCOPE("day8_part2/walk");
+      day8::node iter = from;
+      size_t hops = 0;
+      auto next_of = [&hops, this](day8::node const &n) {
+        return branches[hops % branches.size()] == 'L' ? left_of(g, n)
+                                                       : right_of(g, n);
+      };
+      while (!iter.ends_with('Z')) {
+        iter = next_of(iter);
+        ++hops;
+      }
+      AOC_DEBUG("from {} to {} : {} hops!", from, iter, hops);
+      AOC_COUNT("day8_part2/node_lookups", hops);
+
+      return hops;
     };
-    fmt::print("from {} ", iter);
-    while (!iter.ends_with('Z')) {
-      iter = next_of(iter);
-      ++hops;
-    }
-    fmt::println("to {} : {} hops!", iter, hops);
 
-    return hops;
-  };
+    auto hops = starting_nodes | ranges::views::transform(calc_hops) |
+                ranges::to_vector;
 
-  auto hops =
-      starting_nodes | ranges::views::transform(calc_hops) | ranges::to_vector;
+    return ranges::fold_left(hops, size_t{1},
+                             [](auto a, auto b) { return std::lcm(a, b); });
+  }
 
-  auto least_common_multiple =
-      ranges::fold_left(hops, 1, [](auto a, auto b) { return std::lcm(a, b); });
+  std::string_view branches;
+  day8::graph::graph g;
+  std::vector<day8::node> starting_nodes;
+};
 
-  fmt::println("least_common_multiple {}", least_common_multiple);
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day8_part2", "day8/input.txt");
 
-  return 0;
-}
+} // namespace
@@ -1,92 +1,115 @@
-#include "args.hpp"
-#include "range_split_strs.hpp"
-#include <_ctype.h>
+#include "instrument.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "parse_int.hpp"
+#include "solver.hpp"
+#include "thread_pool.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
-#include <fstream>
 #include <functional>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <range/v3/all.hpp>
 #include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
 
+namespace {
+
 using seq = std::vector<int64_t>;
 
-int main(int argc, char **argv) {
+seq::value_type extrapolate_next(seq const &rng) {
+  using namespace ranges;
+  if (all_of(rng, [](auto val) { return val == 0; })) {
+    return 0;
+  } else {
+    auto back = accumulate(rng | views::reverse | views::take(1), 0);
+    return back + extrapolate_next(views::zip(rng | views::drop(1), rng) |
+                                   views::transform([](auto t) {
+                                     return std::get<0>(t) - std::get<1>(t);
+                                   }) |
+                                   to_vector);
+  }
+}
+
+seq::value_type extrapolate_prev(seq const &rng) {
+  using namespace ranges;
+  if (all_of(rng, [](auto val) { return val == 0; })) {
+    return 0;
+  } else {
+    auto front = accumulate(rng | views::take(1), 0);
+    return front - extrapolate_prev(views::zip(rng | views::drop(1), rng) |
+                                    views::transform([](auto t) {
+                                      return std::get<0>(t) - std::get<1>(t);
+                                    }) |
+                                    to_vector);
+  }
+}
 
-  auto args = parse_args(argc, argv);
+// sequences of a run of lines
+std::vector<seq> parse_sequences(std::string_view lines) {
+  std::vector<seq> sequences;
+  for (std::string_view line : line_range{lines}) {
+    if (line.empty()) {
+      continue;
+    }
 
-  if (args.size() < 2) {
-    fmt::println("usage: {} <input_file>",
-                 std::filesystem::path(args[0]).filename().string());
-    return -1;
+    sequences.push_back(aoc::parse_ints<seq::value_type>(line));
   }
+  return sequences;
+}
 
-  std::filesystem::path path(args[1]);
-  std::ifstream ifs;
+struct solution {
 
-  ifs.open(path);
+  explicit solution(args_t const &params) : pool(aoc::make_pool(params)) {}
 
-  if (!ifs.good()) {
-    fmt::println("cannot open file: {}", args[1]);
-    return -1;
+  void parse(std::string_view input) {
+    AOC_SCOPE("day9/parse_sequences");
+    sequences = aoc::parallel_reduce_lines(
+        pool.get(), input, std::vector<seq>{}, parse_sequences, aoc::append);
   }
 
-  std::function<seq::value_type(seq)> extrapolate_next =
-      [&](auto &&rng) -> seq::value_type {
-    using namespace ranges;
-    if (all_of(rng, [](auto val) { return val == 0; })) {
-      return 0;
-    } else {
-      auto back = accumulate(rng | views::reverse | views::take(1), 0);
-      return back + extrapolate_next(views::zip(rng | views::drop(1), rng) |
-                                     views::transform([](auto t) {
-                                       return std::get<0>(t) - std::get<1>(t);
-                                     }) |
-                                     to_vector);
-    }
-  };
+  // next elements summed
+  int64_t part1() const {
+    AOC_SCOPE("day9/extrapolate_next");
+    auto next_sum = [this](std::size_t begin, std::size_t end) {
+      int64_t next_elements_sum = 0;
+      for (auto const &rng : sequences | ranges::views::slice(begin, end)) {
+        int64_t next = extrapolate_next(rng);
+        next_elements_sum += next;
+        AOC_TRACE("range: {} extrapolated next: {}", rng, next);
+      }
+      return next_elements_sum;
+    };
+    return aoc::parallel_reduce(pool.get(), sequences.size(), int64_t{0},
+                                next_sum, std::plus<>{});
+  }
 
-  std::function<seq::value_type(seq)> extrapolate_prev =
-      [&](auto &&rng) -> seq::value_type {
-    using namespace ranges;
-    if (all_of(rng, [](auto val) { return val == 0; })) {
-      return 0;
-    } else {
-      auto front = accumulate(rng | views::take(1), 0);
-      return front - extrapolate_prev(views::zip(rng | views::drop(1), rng) |
-                                      views::transform([](auto t) {
-                                        return std::get<0>(t) - std::get<1>(t);
-                                      }) |
-                                      to_vector);
-    }
-  };
+  // prev elements summed
+  int64_t part2() const {
+    AOC_SCOPE("day9/extrapolate_prev");
+    auto prev_sum = [this](std::size_t begin, std::size_t end) {
+      int64_t prev_elements_sum = 0;
+      for (auto const &rng : sequences | ranges::views::slice(begin, end)) {
+        int64_t prev = extrapolate_prev(rng);
+        prev_elements_sum += prev;
+        AOC_TRACE("range: {} extrapolated prev: {}", rng, prev);
+      }
+      return prev_elements_sum;
+    };
+    return aoc::parallel_reduce(pool.get(), sequences.size(), int64_t{0},
+                                prev_sum, std::plus<>{});
+  }
 
-  int64_t next_elements_sum = 0;
-  int64_t prev_elements_sum = 0;
-  std::string line;
-  while (std::getline(ifs, line)) {
-    if (line.empty()) {
-      continue;
-    }
+  std::vector<seq> sequences;
+  std::unique_ptr<aoc::thread_pool> pool;
+};
 
-    auto rng = line | split_strs(' ') |
-               ranges::views::transform(
-                   [](std::string const &str) { return std::stoll(str); }) |
-               ranges::to_vector;
-    int64_t next = extrapolate_next(rng);
-    int64_t prev = extrapolate_prev(rng);
-    next_elements_sum += next;
-    prev_elements_sum += prev;
-    fmt::println("range: {} extrapolated: {}, {}", rng, prev, next);
-  }
-  fmt::println("next elements summed: {}", next_elements_sum);
-  fmt::println("prev elements summed: {}", prev_elements_sum);
+[[maybe_unused]] bool const registered =
+    aoc::register_solver<solution>("day9", "day9/input.txt");
 
-  return 0;
-}
+} // namespace
@@ -0,0 +1,577 @@
+// emits puzzle-format inputs of arbitrary size, for scaling measurements
+#include "args.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fmt/core.h>
+#include <fmt/format.h>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using rng_t = std::mt19937_64;
+
+// buffered writer, the outputs easily get to tens of gigabytes
+struct writer {
+
+  explicit writer(std::FILE *out) : out_(out) {}
+  ~writer() { flush(); }
+
+  template <typename... Args>
+  void print(fmt::format_string<Args...> fmt, Args &&...args) {
+    fmt::format_to(std::back_inserter(buf_), fmt, std::forward<Args>(args)...);
+    if (buf_.size() > (1 << 20)) {
+      flush();
+    }
+  }
+
+  void put(char c) {
+    buf_.push_back(c);
+    if (buf_.size() > (1 << 20)) {
+      flush();
+    }
+  }
+
+  void put(std::string_view str) {
+    buf_.append(str);
+    if (buf_.size() > (1 << 20)) {
+      flush();
+    }
+  }
+
+  void flush() {
+    std::fwrite(buf_.data(), 1, buf_.size(), out_);
+    buf_.clear();
+  }
+
+private:
+  std::FILE *out_;
+  fmt::memory_buffer buf_;
+};
+
+struct options {
+  std::size_t size;
+  // grid days only, defaults to size
+  std::optional<std::size_t> width;
+  std::uint64_t seed;
+};
+
+template <typename T> T uniform(rng_t &rng, T lo, T hi) {
+  return std::uniform_int_distribution<T>(lo, hi)(rng);
+}
+
+bool chance(rng_t &rng, double p) {
+  return std::bernoulli_distribution(p)(rng);
+}
+
+template <typename T> T const &pick(rng_t &rng, std::vector<T> const &from) {
+  return from[uniform<std::size_t>(rng, 0, from.size() - 1)];
+}
+
+// distinct values from [lo, hi]
+std::vector<int> sample(rng_t &rng, int lo, int hi, int count) {
+  std::vector<int> all(hi - lo + 1);
+  std::iota(all.begin(), all.end(), lo);
+  std::shuffle(all.begin(), all.end(), rng);
+  all.resize(count);
+  return all;
+}
+
+// size: lines
+void day1(writer &out, options const &opt, rng_t &rng) {
+  static std::vector<std::string_view> const words = {
+      "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+
+  for (std::size_t line = 0; line < opt.size; ++line) {
+    auto tokens = uniform(rng, 2, 10);
+    auto digit_at = uniform(rng, 0, tokens - 1);
+    for (int t = 0; t < tokens; ++t) {
+      if (t == digit_at or chance(rng, 0.2)) {
+        out.put(static_cast<char>('1' + uniform(rng, 0, 8)));
+      } else if (chance(rng, 0.3)) {
+        out.put(pick(rng, words));
+      } else {
+        for (int c = uniform(rng, 1, 4); c > 0; --c) {
+          out.put(static_cast<char>('a' + uniform(rng, 0, 25)));
+        }
+      }
+    }
+    out.put('\n');
+  }
+}
+
+// size: games
+void day2(writer &out, options const &opt, rng_t &rng) {
+  static std::vector<std::string_view> const colors = {"red", "green", "blue"};
+
+  for (std::size_t game = 1; game <= opt.size; ++game) {
+    out.print("Game {}:", game);
+    for (int roll = uniform(rng, 1, 6); roll > 0; --roll) {
+      auto shown = sample(rng, 0, 2, uniform(rng, 1, 3));
+      for (std::size_t c = 0; c < shown.size(); ++c) {
+        out.print(" {} {}{}", uniform(rng, 1, 20), colors[shown[c]],
+                  c + 1 < shown.size() ? "," : "");
+      }
+      out.put(roll > 1 ? ";" : "");
+    }
+    out.put('\n');
+  }
+}
+
+// size: rows, width: columns (140 like the puzzle)
+void day3(writer &out, options const &opt, rng_t &rng) {
+  static std::string_view const symbols = "*#+$/@%=&-";
+
+  auto width = opt.width.value_or(140);
+  std::string row(width, '.');
+  for (std::size_t r = 0; r < opt.size; ++r) {
+    std::ranges::fill(row, '.');
+    for (std::size_t c = 0; c < width;) {
+      if (chance(rng, 0.08)) {
+        auto digits = uniform<std::size_t>(rng, 1, 3);
+        for (std::size_t d = 0; d < digits and c < width; ++d, ++c) {
+          // no leading zeros
+          row[c] = static_cast<char>(d ? '0' + uniform(rng, 0, 9)
+                                       : '1' + uniform(rng, 0, 8));
+        }
+        // keep neighbouring numbers apart
+        ++c;
+      } else {
+        if (chance(rng, 0.04)) {
+          row[c] = symbols[uniform<std::size_t>(rng, 0, symbols.size() - 1)];
+        }
+        ++c;
+      }
+    }
+    out.put(row);
+    out.put('\n');
+  }
+}
+
+// size: cards. Match counts average below one so copy counts stay finite
+void day4(writer &out, options const &opt, rng_t &rng) {
+  for (std::size_t card = 1; card <= opt.size; ++card) {
+    std::size_t left = opt.size - card;
+    int matches = chance(rng, 0.7) ? 0 : uniform(rng, 1, 4);
+    matches = static_cast<int>(std::min<std::size_t>(matches, left));
+
+    auto numbers = sample(rng, 1, 99, 35);
+    std::vector<int> winning(numbers.begin(), numbers.begin() + 10);
+    std::vector<int> have(numbers.begin() + 10, numbers.begin() + 10 + 25);
+    std::copy_n(winning.begin(), matches, have.begin());
+    std::shuffle(have.begin(), have.end(), rng);
+
+    out.print("Card {:>3}:", card);
+    for (int n : winning) {
+      out.print(" {:>2}", n);
+    }
+    out.put(" |");
+    for (int n : have) {
+      out.print(" {:>2}", n);
+    }
+    out.put('\n');
+  }
+}
+
+// size: rules per map. Every map is a permutation of disjoint intervals
+void day5(writer &out, options const &opt, rng_t &rng) {
+  static std::vector<std::string_view> const maps = {
+      "seed-to-soil",         "soil-to-fertilizer",   "fertilizer-to-water",
+      "water-to-light",       "light-to-temperature", "temperature-to-humidity",
+      "humidity-to-location"};
+
+  std::uint64_t const space = std::uint64_t{1} << 32;
+
+  out.put("seeds:");
+  for (int pair = 0; pair < 10; ++pair) {
+    auto len = uniform<std::uint64_t>(rng, 1, 1000000);
+    out.print(" {} {}", uniform<std::uint64_t>(rng, 0, space - len - 1), len);
+  }
+  out.put("\n");
+
+  auto rules = std::max<std::size_t>(opt.size, 1);
+  for (auto name : maps) {
+    std::vector<std::uint64_t> cuts(rules - 1);
+    for (auto &cut : cuts) {
+      cut = uniform<std::uint64_t>(rng, 1, space - 1);
+    }
+    cuts.push_back(0);
+    cuts.push_back(space);
+    std::ranges::sort(cuts);
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    std::vector<std::size_t> order(cuts.size() - 1);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    out.print("\n{} map:\n", name);
+    std::uint64_t dest = 0;
+    for (auto idx : order) {
+      auto len = cuts[idx + 1] - cuts[idx];
+      out.print("{} {} {}\n", dest, cuts[idx], len);
+      dest += len;
+    }
+  }
+}
+
+// size: races. Part 2 glues all of them into one number, keep it small
+void day6(writer &out, options const &opt, rng_t &rng) {
+  std::vector<std::uint64_t> times(opt.size);
+  std::vector<std::uint64_t> records(opt.size);
+  for (std::size_t i = 0; i < opt.size; ++i) {
+    times[i] = uniform<std::uint64_t>(rng, 7, 99);
+    auto best = (times[i] / 2) * (times[i] - times[i] / 2);
+    records[i] = uniform<std::uint64_t>(rng, 1, best - 1);
+  }
+
+  out.put("Time:    ");
+  for (auto t : times) {
+    out.print(" {:>4}", t);
+  }
+  out.put("\nDistance:");
+  for (auto r : records) {
+    out.print(" {:>4}", r);
+  }
+  out.put('\n');
+}
+
+// size: hands
+void day7(writer &out, options const &opt, rng_t &rng) {
+  static std::string_view const cards = "23456789TJQKA";
+
+  for (std::size_t hand = 0; hand < opt.size; ++hand) {
+    for (int c = 0; c < 5; ++c) {
+      out.put(cards[uniform<std::size_t>(rng, 0, cards.size() - 1)]);
+    }
+    out.print(" {}\n", uniform(rng, 1, 1000));
+  }
+}
+
+bool is_prime(std::size_t n) {
+  if (n < 2) {
+    return false;
+  }
+  for (std::size_t d = 2; d * d <= n; ++d) {
+    if (n % d == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// size: nodes. Six ghosts each walk their own cycle whose length is a
+// distinct prime multiple of the instruction count, like the puzzle
+void day8(writer &out, options const &opt, rng_t &rng) {
+  std::size_t const ghosts = 6;
+  std::size_t const instructions = 263;
+
+  std::vector<std::size_t> periods;
+  auto per_ghost = std::max<std::size_t>(opt.size / ghosts / instructions, 2);
+  for (std::size_t p = per_ghost; periods.size() < ghosts; ++p) {
+    if (is_prime(p)) {
+      periods.push_back(p);
+    }
+  }
+  auto nodes = std::reduce(periods.begin(), periods.end()) * instructions;
+
+  // fixed width names, the last letter is reserved for A (start) and Z (end)
+  std::size_t width = 3;
+  std::size_t prefixes = 26 * 26;
+  for (; prefixes * 24 < nodes; prefixes *= 26) {
+    ++width;
+  }
+  auto encode = [width](std::size_t n, char last) {
+    std::string name(width, 'A');
+    name.back() = last;
+    for (std::size_t i = width - 1; i-- > 0;) {
+      name[i] = static_cast<char>('A' + n % 26);
+      n /= 26;
+    }
+    return name;
+  };
+
+  for (std::size_t i = 0; i < instructions; ++i) {
+    out.put(chance(rng, 0.5) ? 'L' : 'R');
+  }
+  out.put("\n\n");
+
+  std::size_t next_id = 0;
+  auto fresh = [&] {
+    auto id = next_id++;
+    return encode(id / 24, static_cast<char>('B' + id % 24));
+  };
+
+  for (std::size_t g = 0; g < ghosts; ++g) {
+    auto cycle_len = periods[g] * instructions;
+    std::vector<std::string> cycle;
+    cycle.reserve(cycle_len);
+    for (std::size_t i = 0; i + 1 < cycle_len; ++i) {
+      cycle.push_back(fresh());
+    }
+    // ghost 0 walks AAA -> ZZZ for part 1
+    cycle.push_back(encode(prefixes - 1 - g, 'Z'));
+    auto start = encode(g, 'A');
+
+    out.print("{} = ({}, {})\n", start, cycle.front(), cycle.front());
+    for (std::size_t i = 0; i < cycle.size(); ++i) {
+      auto const &to = cycle[(i + 1) % cycle.size()];
+      out.print("{} = ({}, {})\n", cycle[i], to, to);
+    }
+  }
+}
+
+// size: sequences of 21 values generated by polynomials of degree <= 5
+void day9(writer &out, options const &opt, rng_t &rng) {
+  for (std::size_t seq = 0; seq < opt.size; ++seq) {
+    std::vector<std::int64_t> coeffs(uniform(rng, 1, 6));
+    for (auto &c : coeffs) {
+      c = uniform<std::int64_t>(rng, -9, 9);
+    }
+    for (std::int64_t x = 0; x < 21; ++x) {
+      std::int64_t val = 0;
+      for (auto c : coeffs) {
+        val = val * x + c;
+      }
+      out.print("{}{}", x ? " " : "", val);
+    }
+    out.put('\n');
+  }
+}
+
+// size: rows, width: columns. One comb shaped loop with junk around it
+void day10(writer &out, options const &opt, rng_t &rng) {
+  static std::string_view const junk = "|-LJ7F...";
+
+  std::size_t height = std::max<std::size_t>(opt.size, 5);
+  std::size_t width = std::max<std::size_t>(opt.width.value_or(height), 6);
+
+  std::vector<std::string> grid(height);
+  for (auto &row : grid) {
+    row.resize(width);
+    for (char &c : row) {
+      c = junk[uniform<std::size_t>(rng, 0, junk.size() - 1)];
+    }
+  }
+
+  // loop cells in walking order: three column wide teeth standing on the
+  // bottom row, so there are tiles both inside and outside of the loop
+  using cell = std::pair<std::size_t, std::size_t>;
+  std::size_t bottom = height - 2;
+  std::vector<cell> loop{{bottom - 1, 1}};
+  auto line_to = [&loop](std::size_t r, std::size_t c) {
+    auto [cr, cc] = loop.back();
+    while (cr != r or cc != c) {
+      cr += (cr < r) - (cr > r);
+      cc += (cc < c) - (cc > c);
+      loop.push_back({cr, cc});
+    }
+  };
+
+  std::size_t col = 1;
+  while (true) {
+    line_to(1, col);
+    line_to(1, col + 2);
+    line_to(bottom - 1, col + 2);
+    if (col + 6 > width - 2) {
+      break;
+    }
+    col += 4;
+    line_to(bottom - 1, col);
+  }
+  line_to(bottom, col + 2);
+  line_to(bottom, 1);
+
+  auto pipe = [](int dr1, int dc1, int dr2, int dc2) {
+    auto has = [&](int dr, int dc) {
+      return (dr1 == dr and dc1 == dc) or (dr2 == dr and dc2 == dc);
+    };
+    if (has(-1, 0) and has(1, 0)) {
+      return '|';
+    } else if (has(0, -1) and has(0, 1)) {
+      return '-';
+    } else if (has(-1, 0) and has(0, 1)) {
+      return 'L';
+    } else if (has(-1, 0) and has(0, -1)) {
+      return 'J';
+    } else if (has(1, 0) and has(0, -1)) {
+      return '7';
+    }
+    return 'F';
+  };
+
+  for (std::size_t i = 0; i < loop.size(); ++i) {
+    auto [r, c] = loop[i];
+    auto [pr, pc] = loop[(i + loop.size() - 1) % loop.size()];
+    auto [nr, nc] = loop[(i + 1) % loop.size()];
+    grid[r][c] = pipe(int(pr) - int(r), int(pc) - int(c), int(nr) - int(r),
+                      int(nc) - int(c));
+  }
+
+  // nothing but the loop may connect to the start
+  auto [sr, sc] = loop.back();
+  grid[sr][sc] = 'S';
+  grid[sr][sc - 1] = '.';
+  grid[sr + 1][sc] = '.';
+
+  for (auto const &row : grid) {
+    out.put(row);
+    out.put('\n');
+  }
+}
+
+// size: rows, width: columns
+void day11(writer &out, options const &opt, rng_t &rng) {
+  auto width = opt.width.value_or(opt.size);
+
+  std::vector<bool> empty_col(width);
+  for (std::size_t c = 0; c < width; ++c) {
+    empty_col[c] = chance(rng, 0.05);
+  }
+
+  std::string row(width, '.');
+  for (std::size_t r = 0; r < opt.size; ++r) {
+    std::ranges::fill(row, '.');
+    if (!chance(rng, 0.05)) {
+      for (std::size_t c = 0; c < width; ++c) {
+        if (!empty_col[c] and chance(rng, 0.02)) {
+          row[c] = '#';
+        }
+      }
+    }
+    out.put(row);
+    out.put('\n');
+  }
+}
+
+struct generator {
+  std::string_view day;
+  // same layout as the repository, so aoc_bench --inputs can pick it up
+  std::string_view path;
+  std::size_t default_size;
+  std::function<void(writer &, options const &, rng_t &)> run;
+};
+
+std::vector<generator> const generators = {
+    {"day1", "day1/input.txt", 1000, day1},
+    {"day2", "day2/input.txt", 100, day2},
+    {"day3", "day3/input.txt", 140, day3},
+    {"day4", "day4/input.txt", 198, day4},
+    {"day5", "day5/input.txt", 40, day5},
+    {"day6", "day6/input.txt", 4, day6},
+    {"day7", "day7/input.txt", 1000, day7},
+    {"day8", "day8/input.txt", 10000, day8},
+    {"day9", "day9/input.txt", 200, day9},
+    {"day10", "day10/input", 140, day10},
+    {"day11", "day11/input", 140, day11},
+};
+
+template <typename T> std::optional<T> to_number(std::string_view str) {
+  T out{};
+  auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), out);
+  if (ec != std::errc{} or ptr != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+void usage(std::string_view self) {
+  fmt::println(
+      "usage: {} [--size <n>] [--width <n>] [--seed <n>] "
+      "[-o <file> | --out-dir <dir>] <all | day>...",
+      std::filesystem::path(self).filename().string());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  auto args = parse_args(argc, argv);
+
+  std::optional<std::size_t> size;
+  std::optional<std::size_t> width;
+  std::uint64_t seed = 2023;
+  std::optional<std::filesystem::path> out_file;
+  std::optional<std::filesystem::path> out_dir;
+  std::vector<generator const *> selected;
+
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    bool has_value = i + 1 < args.size();
+    if (args[i] == "--size" and has_value) {
+      size = to_number<std::size_t>(args[++i]);
+      if (!size) {
+        usage(args[0]);
+        return -1;
+      }
+    } else if (args[i] == "--width" and has_value) {
+      width = to_number<std::size_t>(args[++i]);
+      if (!width) {
+        usage(args[0]);
+        return -1;
+      }
+    } else if (args[i] == "--seed" and has_value) {
+      auto s = to_number<std::uint64_t>(args[++i]);
+      if (!s) {
+        usage(args[0]);
+        return -1;
+      }
+      seed = *s;
+    } else if (args[i] == "-o" and has_value) {
+      out_file = args[++i];
+    } else if (args[i] == "--out-dir" and has_value) {
+      out_dir = args[++i];
+    } else if (args[i] == "all") {
+      for (auto const &gen : generators) {
+        selected.push_back(&gen);
+      }
+    } else if (auto it = std::ranges::find(generators, args[i],
+                                           &generator::day);
+               it != generators.end()) {
+      selected.push_back(&*it);
+    } else {
+      usage(args[0]);
+      return -1;
+    }
+  }
+
+  if (selected.empty() or (out_file and selected.size() != 1)) {
+    usage(args[0]);
+    return -1;
+  }
+
+  for (auto const *gen : selected) {
+    options opt{size.value_or(gen->default_size), width, seed};
+    rng_t rng(seed);
+
+    std::FILE *fp = stdout;
+    if (out_dir or out_file) {
+      auto path = out_file ? *out_file : *out_dir / gen->path;
+      if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+      }
+      fp = std::fopen(path.c_str(), "w");
+      if (!fp) {
+        fmt::println("cannot open file: {}", path.string());
+        return -1;
+      }
+    }
+
+    {
+      writer out(fp);
+      gen->run(out, opt, rng);
+    }
+
+    if (fp != stdout) {
+      std::fclose(fp);
+    }
+  }
+
+  return 0;
+}
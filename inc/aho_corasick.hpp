@@ -0,0 +1,232 @@
+#pragma once
+
+#include "flat_trie.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Multi pattern scanner: the words are compiled into a complete automaton
+// (Aho-Corasick with the failure links folded into the transition table), so
+// a text is matched in one left to right pass, one table lookup per byte,
+// without restarting at every offset. The goto function is a flat_trie of
+// the words, its node table becomes the automaton's with column 0 added.
+//
+//   aoc::aho_corasick const digits = {{"one", 1}, {"1", 1}, ...};
+//   auto [first, last] = digits.scan(line);
+//
+// `first` is the match starting earliest, `last` the match ending latest,
+// ties go to the shorter word. Characters in none of the words all share one
+// column of the table that leads back to the start state.
+//
+// serialize() / deserialize() round trip the compiled tables, so a large
+// dictionary can be cached instead of being rebuilt. The bytes are in host
+// order and meant for a local cache, not for exchange.
+namespace aoc {
+
+class aho_corasick {
+public:
+  struct match {
+    int value;
+    std::size_t begin;
+    std::size_t length;
+  };
+
+  struct first_last {
+    std::optional<match> first;
+    std::optional<match> last;
+  };
+
+  aho_corasick(std::initializer_list<trie_entry> words)
+      : aho_corasick(std::span(words.begin(), words.size())) {}
+
+  // a repeated word keeps its first value
+  explicit aho_corasick(std::span<trie_entry const> words) {
+    flat_trie trie;
+    for (auto const &[word, val] : words) {
+      trie.insert(word, val);
+    }
+    from_trie(trie);
+    link();
+  }
+
+  first_last scan(std::string_view text) const {
+    first_last out;
+    std::size_t state = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+      auto sym = symbols[static_cast<unsigned char>(text[i])];
+      state = table[state * fanout + sym];
+      auto const &wide = longest[state];
+      if (wide.length == 0) {
+        continue;
+      }
+      auto begin = i + 1 - wide.length;
+      if (!out.first or begin < out.first->begin) {
+        out.first = match{wide.value, begin, wide.length};
+      }
+      auto const &narrow = shortest[state];
+      out.last = match{narrow.value, i + 1 - narrow.length, narrow.length};
+    }
+    return out;
+  }
+
+  std::size_t state_count() const { return longest.size(); }
+
+  std::string serialize() const {
+    std::string out(magic);
+    auto put = [&out](auto const *data, std::size_t count) {
+      out.append(reinterpret_cast<char const *>(data), sizeof(*data) * count);
+    };
+    std::uint64_t sizes[] = {fanout, state_count()};
+    put(sizes, 2);
+    put(symbols.data(), symbols.size());
+    put(table.data(), table.size());
+    for (auto const *outputs : {&longest, &shortest}) {
+      for (auto const &o : *outputs) {
+        std::int64_t pair[] = {static_cast<std::int64_t>(o.length), o.value};
+        put(pair, 2);
+      }
+    }
+    return out;
+  }
+
+  // nullopt unless bytes are exactly what serialize() wrote
+  static std::optional<aho_corasick> deserialize(std::string_view bytes) {
+    if (!bytes.starts_with(magic)) {
+      return std::nullopt;
+    }
+    bytes.remove_prefix(magic.size());
+    auto get = [&bytes](auto *data, std::size_t count) {
+      auto size = sizeof(*data) * count;
+      if (bytes.size() < size) {
+        return false;
+      }
+      std::memcpy(data, bytes.data(), size);
+      bytes.remove_prefix(size);
+      return true;
+    };
+
+    aho_corasick ac;
+    std::uint64_t sizes[2];
+    if (!get(sizes, 2) or sizes[0] == 0 or sizes[0] > 257 or sizes[1] == 0 or
+        bytes.size() / sizes[0] / sizeof(std::uint32_t) < sizes[1]) {
+      return std::nullopt;
+    }
+    ac.fanout = sizes[0];
+    ac.table.resize(sizes[0] * sizes[1]);
+    ac.longest.resize(sizes[1]);
+    ac.shortest.resize(sizes[1]);
+    if (!get(ac.symbols.data(), ac.symbols.size()) or
+        !get(ac.table.data(), ac.table.size())) {
+      return std::nullopt;
+    }
+    for (auto *outputs : {&ac.longest, &ac.shortest}) {
+      for (auto &o : *outputs) {
+        std::int64_t pair[2];
+        if (!get(pair, 2) or pair[0] < 0) {
+          return std::nullopt;
+        }
+        o = {static_cast<std::size_t>(pair[0]), static_cast<int>(pair[1])};
+      }
+    }
+
+    // a corrupt table must not index out of bounds in scan()
+    auto bad_symbol = [&](std::uint16_t sym) { return sym >= ac.fanout; };
+    auto bad_state = [&](std::uint32_t state) { return state >= sizes[1]; };
+    if (!bytes.empty() or std::ranges::any_of(ac.symbols, bad_symbol) or
+        std::ranges::any_of(ac.table, bad_state)) {
+      return std::nullopt;
+    }
+    return ac;
+  }
+
+private:
+  static constexpr std::string_view magic = "aoc-dfa1";
+
+  aho_corasick() = default;
+
+  // a word ending in a state, length 0 when there is none
+  struct output {
+    std::size_t length{0};
+    int value{0};
+  };
+
+  // trie symbol s is column s + 1, trie node n is state n
+  void from_trie(flat_trie const &trie) {
+    for (int c = 0; c < 256; ++c) {
+      if (auto sym = trie.symbol(static_cast<char>(c)); sym >= 0) {
+        symbols[c] = static_cast<std::uint16_t>(sym + 1);
+        fanout = std::max<std::size_t>(fanout, sym + 2);
+      }
+    }
+    auto states = trie.node_count();
+    table.assign(states * fanout, 0);
+    longest.assign(states, {});
+    shortest.assign(states, {});
+
+    // children are always added after their parent, so one pass in node
+    // order knows every depth it needs
+    std::vector<std::size_t> depth(states, 0);
+    for (std::size_t node = 0; node < states; ++node) {
+      for (std::size_t sym = 1; sym < fanout; ++sym) {
+        auto next = trie.child_at(node, static_cast<int>(sym - 1));
+        table[node * fanout + sym] = static_cast<std::uint32_t>(next);
+        if (next != 0) {
+          depth[next] = depth[node] + 1;
+        }
+      }
+      if (auto val = trie.value(node); val and node != 0) {
+        longest[node] = shortest[node] = {depth[node], *val};
+      }
+    }
+  }
+
+  // breadth first, so the failure target of a state is complete before the
+  // state itself: missing edges borrow the failure target's, outputs inherit
+  // the words ending in the failure target
+  void link() {
+    std::vector<std::uint32_t> fail(longest.size(), 0);
+    std::vector<std::uint32_t> queue;
+    for (std::size_t sym = 1; sym < fanout; ++sym) {
+      if (auto next = table[sym]) {
+        queue.push_back(next);
+      }
+    }
+
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+      auto state = queue[head];
+      for (std::size_t sym = 1; sym < fanout; ++sym) {
+        auto &edge = table[state * fanout + sym];
+        auto borrowed = table[fail[state] * fanout + sym];
+        if (edge == 0) {
+          edge = borrowed;
+          continue;
+        }
+        fail[edge] = borrowed;
+        if (longest[edge].length == 0) {
+          longest[edge] = longest[borrowed];
+        }
+        if (shortest[borrowed].length != 0) {
+          shortest[edge] = shortest[borrowed];
+        }
+        queue.push_back(edge);
+      }
+    }
+  }
+
+  // 0 for characters in none of the words
+  std::array<std::uint16_t, 256> symbols{};
+  std::size_t fanout{1};
+  std::vector<std::uint32_t> table;
+  std::vector<output> longest;
+  std::vector<output> shortest;
+};
+
+} // namespace aoc
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Heap traffic counters, fed by the operator new / delete replacement in
+// runner/alloc_tracker.cpp. That one is only linked in when configured with
+// -DAOC_TRACK_ALLOCS=ON, otherwise enabled() is false and every reading is
+// zero.
+namespace aoc::alloc {
+
+constexpr bool enabled() {
+#ifdef AOC_TRACK_ALLOCS
+  return true;
+#else
+  return false;
+#endif
+}
+
+struct counters {
+  std::atomic<std::size_t> allocations{0};
+  std::atomic<std::size_t> allocated_bytes{0};
+  std::atomic<std::size_t> live_bytes{0};
+  std::atomic<std::size_t> peak_bytes{0};
+};
+
+inline constinit counters totals;
+
+inline void on_alloc(std::size_t size) {
+  totals.allocations.fetch_add(1, std::memory_order_relaxed);
+  totals.allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  auto live =
+      totals.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  auto peak = totals.peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak and !totals.peak_bytes.compare_exchange_weak(
+                             peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+inline void on_free(std::size_t size) {
+  totals.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+struct usage {
+  std::size_t allocations{0};
+  std::size_t bytes{0};
+  // highest live heap above the level the window was opened at
+  std::size_t peak_bytes{0};
+};
+
+// heap traffic between construction and close(), windows may nest but the
+// peak is process wide, allocations from other threads are included
+class window {
+public:
+  window()
+      : allocations(totals.allocations.load(std::memory_order_relaxed)),
+        bytes(totals.allocated_bytes.load(std::memory_order_relaxed)),
+        live(totals.live_bytes.load(std::memory_order_relaxed)),
+        outer_peak(totals.peak_bytes.exchange(live)) {}
+
+  usage close() {
+    auto peak = totals.peak_bytes.load(std::memory_order_relaxed);
+    // hand the enclosing window the higher of both peaks
+    auto restored = outer_peak;
+    while (restored > peak and !totals.peak_bytes.compare_exchange_weak(
+                                   peak, restored, std::memory_order_relaxed)) {
+    }
+    return {totals.allocations.load(std::memory_order_relaxed) - allocations,
+            totals.allocated_bytes.load(std::memory_order_relaxed) - bytes,
+            peak > live ? peak - live : 0};
+  }
+
+private:
+  std::size_t allocations;
+  std::size_t bytes;
+  std::size_t live;
+  std::size_t outer_peak;
+};
+
+} // namespace aoc::alloc
@@ -1,4 +1,10 @@
+#pragma once
+
+#include <cstring>
+#include <algorithm>
 #include <filesystem>
+#include <initializer_list>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -12,3 +18,28 @@ inline args_t parse_args(int argc, char **argv) {
 
   return args;
 }
+
+// params with every "--flag" taken out, together with the value following
+// the ones named in `valued`
+inline args_t positional(args_t const &params,
+                         std::initializer_list<std::string_view> valued) {
+  args_t rest;
+  for (std::size_t i = 0; i < params.size(); ++i) {
+    if (!params[i].starts_with("--")) {
+      rest.push_back(params[i]);
+    } else if (std::ranges::find(valued, params[i]) != valued.end()) {
+      ++i;
+    }
+  }
+  return rest;
+}
+
+// value of the "--name value" option, nullopt when absent or missing its value
+inline std::optional<std::string_view> option(args_t const &params,
+                                              std::string_view name) {
+  auto it = std::ranges::find(params, name);
+  if (it == params.end() or it + 1 == params.end()) {
+    return std::nullopt;
+  }
+  return *(it + 1);
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Tries with every node in one contiguous table instead of a hash map per
+// node. Characters are first mapped to a small alphabet, a node is then a row
+// of `fanout` child indices, so a step is two lookups into flat arrays. Index
+// 0 is the root, which is never anybody's child and doubles as "no child".
+//
+//   flat_trie                    grows at run time, same API as trie.hpp
+//   static_trie<Nodes, Fanout>   fixed capacity, can be built constexpr:
+//
+//   constexpr aoc::static_trie<16> digits = {{"one", 1}, {"two", 2}};
+//   static_assert(digits.search("two") == 2);
+namespace aoc {
+
+using trie_entry = std::pair<std::string_view, int>;
+
+namespace detail {
+
+// lookups shared by both layouts, Trie provides
+//   child(node, c) -> index or 0, value(node) -> std::optional<int>
+//   symbol(c) -> alphabet index or -1, child_at(node, symbol) -> index or 0
+template <typename Trie> struct trie_lookup {
+
+  constexpr bool has_prefix(std::string_view prefix) const {
+    return walk(prefix).has_value();
+  }
+
+  constexpr std::optional<int> search(std::string_view word) const {
+    if (auto node = walk(word)) {
+      return self().value(*node);
+    }
+    return std::nullopt;
+  }
+
+  // value of the shortest word text starts with
+  constexpr std::optional<int> match_prefix(std::string_view text) const {
+    std::size_t node = 0;
+    for (char c : text) {
+      node = self().child(node, c);
+      if (node == 0) {
+        return std::nullopt;
+      }
+      if (auto val = self().value(node)) {
+        return val;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // every word, in character order
+  std::vector<std::string> list_all() const {
+    std::vector<std::string> all;
+    std::string prefix;
+    // node, length of its word and the character leading to it
+    struct pending {
+      std::size_t node;
+      std::size_t depth;
+      char last;
+    };
+    std::vector<pending> stack{{0, 0, '\0'}};
+
+    while (!stack.empty()) {
+      auto [node, depth, last] = stack.back();
+      stack.pop_back();
+      if (depth > 0) {
+        prefix.resize(depth - 1);
+        prefix.push_back(last);
+      }
+      if (self().value(node)) {
+        all.push_back(prefix);
+      }
+      // pushed in reverse so the smallest character comes off first
+      for (int c = 255; c >= 0; --c) {
+        auto sym = self().symbol(static_cast<char>(c));
+        if (sym < 0) {
+          continue;
+        }
+        if (auto next = self().child_at(node, sym)) {
+          stack.push_back({next, depth + 1, static_cast<char>(c)});
+        }
+      }
+    }
+    return all;
+  }
+
+private:
+  constexpr Trie const &self() const {
+    return static_cast<Trie const &>(*this);
+  }
+
+  constexpr std::optional<std::size_t> walk(std::string_view str) const {
+    std::size_t node = 0;
+    for (char c : str) {
+      node = self().child(node, c);
+      if (node == 0) {
+        return std::nullopt;
+      }
+    }
+    return node;
+  }
+};
+
+} // namespace detail
+
+template <std::size_t MaxNodes, std::size_t Fanout = 32>
+class static_trie : public detail::trie_lookup<static_trie<MaxNodes, Fanout>> {
+  static_assert(MaxNodes <= 0x10000, "node indices are 16 bit");
+
+public:
+  constexpr static_trie() { symbols.fill(-1); }
+
+  constexpr static_trie(std::initializer_list<trie_entry> init)
+      : static_trie() {
+    for (auto const &[word, val] : init) {
+      insert(word, val);
+    }
+  }
+
+  constexpr bool insert(std::string_view word, int val) {
+    std::size_t node = 0;
+    for (char c : word) {
+      auto &next = table[node][symbol_for(c)];
+      if (next == 0) {
+        if (nodes == MaxNodes) {
+          throw std::length_error("static_trie: out of nodes");
+        }
+        next = static_cast<std::uint16_t>(nodes++);
+      }
+      node = next;
+    }
+    if (has_value[node]) {
+      return false;
+    }
+    has_value[node] = true;
+    values[node] = val;
+    return true;
+  }
+
+  constexpr std::size_t child(std::size_t node, char c) const {
+    auto sym = symbol(c);
+    return sym < 0 ? 0 : table[node][sym];
+  }
+
+  constexpr std::size_t child_at(std::size_t node, int sym) const {
+    return table[node][sym];
+  }
+
+  constexpr std::optional<int> value(std::size_t node) const {
+    if (has_value[node]) {
+      return values[node];
+    }
+    return std::nullopt;
+  }
+
+  constexpr int symbol(char c) const {
+    return symbols[static_cast<unsigned char>(c)];
+  }
+
+  constexpr std::size_t node_count() const { return nodes; }
+
+private:
+  constexpr int symbol_for(char c) {
+    auto &sym = symbols[static_cast<unsigned char>(c)];
+    if (sym < 0) {
+      if (alphabet == Fanout) {
+        throw std::length_error("static_trie: alphabet exceeds fanout");
+      }
+      sym = static_cast<std::int16_t>(alphabet++);
+    }
+    return sym;
+  }
+
+  std::array<std::int16_t, 256> symbols{};
+  std::size_t alphabet{0};
+  std::array<std::array<std::uint16_t, Fanout>, MaxNodes> table{};
+  std::array<int, MaxNodes> values{};
+  std::array<bool, MaxNodes> has_value{};
+  std::size_t nodes{1};
+};
+
+class flat_trie : public detail::trie_lookup<flat_trie> {
+public:
+  flat_trie() {
+    symbols.fill(-1);
+    table.resize(fanout);
+    values.emplace_back();
+  }
+
+  flat_trie(std::initializer_list<trie_entry> init) : flat_trie() {
+    for (auto const &[word, val] : init) {
+      insert(word, val);
+    }
+  }
+
+  bool insert(std::string_view word, int val) {
+    std::size_t node = 0;
+    for (char c : word) {
+      auto sym = symbol_for(c);
+      auto next = table[node * fanout + sym];
+      if (next == 0) {
+        next = static_cast<std::uint32_t>(values.size());
+        table[node * fanout + sym] = next;
+        table.resize(table.size() + fanout);
+        values.emplace_back();
+      }
+      node = next;
+    }
+    if (values[node]) {
+      return false;
+    }
+    values[node] = val;
+    return true;
+  }
+
+  std::size_t child(std::size_t node, char c) const {
+    auto sym = symbol(c);
+    return sym < 0 ? 0 : table[node * fanout + sym];
+  }
+
+  std::size_t child_at(std::size_t node, int sym) const {
+    return table[node * fanout + sym];
+  }
+
+  std::optional<int> value(std::size_t node) const { return values[node]; }
+
+  int symbol(char c) const { return symbols[static_cast<unsigned char>(c)]; }
+
+  std::size_t node_count() const { return values.size(); }
+
+private:
+  int symbol_for(char c) {
+    auto &sym = symbols[static_cast<unsigned char>(c)];
+    if (sym < 0) {
+      if (alphabet == fanout) {
+        widen(fanout * 2);
+      }
+      sym = static_cast<std::int16_t>(alphabet++);
+    }
+    return sym;
+  }
+
+  // a new character did not fit the rows, lay the table out again
+  void widen(std::size_t wider) {
+    std::vector<std::uint32_t> relaid(values.size() * wider);
+    for (std::size_t node = 0; node < values.size(); ++node) {
+      std::copy_n(table.begin() + node * fanout, fanout,
+                  relaid.begin() + node * wider);
+    }
+    table = std::move(relaid);
+    fanout = wider;
+  }
+
+  std::array<std::int16_t, 256> symbols{};
+  std::size_t alphabet{0};
+  std::size_t fanout{8};
+  std::vector<std::uint32_t> table;
+  std::vector<std::optional<int>> values;
+};
+
+} // namespace aoc
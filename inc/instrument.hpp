@@ -0,0 +1,287 @@
+#pragma once
+
+#include "alloc_tracker.hpp"
+#include "json.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fmt/core.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Scoped timers and named counters for the solvers' hot paths.
+//
+//   AOC_SCOPE("day5/map_stage");          // times the enclosing block
+//   AOC_COUNT("day5/ranges_mapped", n);   // adds n to a named counter
+//
+// Every thread records into its own log, so the hot path takes no lock.
+// Recording is off until set_enabled(true), a disabled scope costs a single
+// relaxed load. Building with AOC_INSTRUMENT=0 removes the macros entirely.
+// With AOC_TRACK_ALLOCS the scopes also record their heap traffic.
+//
+// Names must outlive the report, string literals or registered solver names.
+// reset(), summary() and the writers expect no instrumented code running.
+#ifndef AOC_INSTRUMENT
+#define AOC_INSTRUMENT 1
+#endif
+
+namespace aoc::instrument {
+
+using clock = std::chrono::steady_clock;
+
+struct event {
+  std::string_view name;
+  clock::time_point start;
+  clock::duration elapsed;
+  alloc::usage heap;
+};
+
+struct thread_log {
+  unsigned tid{0};
+  std::vector<event> events;
+  std::vector<std::pair<std::string_view, std::int64_t>> counters;
+};
+
+namespace detail {
+
+struct state {
+  std::mutex mutex;
+  // logs are never freed, threads keep a pointer to theirs
+  std::vector<std::unique_ptr<thread_log>> threads;
+  clock::time_point epoch{clock::now()};
+  std::atomic<bool> enabled{false};
+};
+
+inline state &global() {
+  static state s;
+  return s;
+}
+
+inline thread_log &local() {
+  thread_local thread_log *log = [] {
+    auto &g = global();
+    std::lock_guard lock(g.mutex);
+    auto &added = g.threads.emplace_back(std::make_unique<thread_log>());
+    added->tid = static_cast<unsigned>(g.threads.size());
+    return added.get();
+  }();
+  return *log;
+}
+
+} // namespace detail
+
+inline bool enabled() {
+  return detail::global().enabled.load(std::memory_order_relaxed);
+}
+
+inline void set_enabled(bool on) {
+  detail::global().enabled.store(on, std::memory_order_relaxed);
+}
+
+inline void reset() {
+  auto &g = detail::global();
+  std::lock_guard lock(g.mutex);
+  for (auto &log : g.threads) {
+    log->events.clear();
+    log->counters.clear();
+  }
+  g.epoch = clock::now();
+}
+
+inline void count(std::string_view name, std::int64_t delta = 1) {
+  if (!enabled()) {
+    return;
+  }
+  auto &counters = detail::local().counters;
+  auto it = std::ranges::find_if(
+      counters, [&](auto const &counter) { return counter.first == name; });
+  if (it == counters.end()) {
+    counters.emplace_back(name, delta);
+  } else {
+    it->second += delta;
+  }
+}
+
+class scope {
+public:
+  explicit scope(std::string_view name) : name(name) {
+    if (enabled()) {
+#ifdef AOC_TRACK_ALLOCS
+      heap.emplace();
+#endif
+      start = clock::now();
+    }
+  }
+
+  ~scope() {
+    if (start != clock::time_point{}) {
+      auto elapsed = clock::now() - start;
+      alloc::usage used;
+#ifdef AOC_TRACK_ALLOCS
+      used = heap->close();
+#endif
+      detail::local().events.push_back({name, start, elapsed, used});
+    }
+  }
+
+  scope(scope const &) = delete;
+  scope &operator=(scope const &) = delete;
+
+private:
+  std::string_view name;
+  clock::time_point start{};
+#ifdef AOC_TRACK_ALLOCS
+  std::optional<alloc::window> heap;
+#endif
+};
+
+struct scope_stats {
+  std::string_view name;
+  std::size_t calls{0};
+  clock::duration total{};
+  clock::duration min{clock::duration::max()};
+  clock::duration max{};
+  std::size_t allocations{0};
+  std::size_t allocated_bytes{0};
+  std::size_t peak_bytes{0};
+};
+
+struct report {
+  // sorted by total time, longest first
+  std::vector<scope_stats> scopes;
+  std::vector<std::pair<std::string_view, std::int64_t>> counters;
+};
+
+inline report summary() {
+  auto &g = detail::global();
+  std::lock_guard lock(g.mutex);
+
+  std::map<std::string_view, scope_stats> scopes;
+  std::map<std::string_view, std::int64_t> counters;
+  for (auto const &log : g.threads) {
+    for (auto const &ev : log->events) {
+      auto &stats = scopes[ev.name];
+      stats.name = ev.name;
+      ++stats.calls;
+      stats.total += ev.elapsed;
+      stats.min = std::min(stats.min, ev.elapsed);
+      stats.max = std::max(stats.max, ev.elapsed);
+      stats.allocations += ev.heap.allocations;
+      stats.allocated_bytes += ev.heap.bytes;
+      stats.peak_bytes = std::max(stats.peak_bytes, ev.heap.peak_bytes);
+    }
+    for (auto const &[name, value] : log->counters) {
+      counters[name] += value;
+    }
+  }
+
+  report result;
+  for (auto const &[name, stats] : scopes) {
+    result.scopes.push_back(stats);
+  }
+  std::ranges::sort(result.scopes, std::ranges::greater{},
+                    &scope_stats::total);
+  result.counters.assign(counters.begin(), counters.end());
+  return result;
+}
+
+inline void write_summary(std::FILE *out) {
+  auto ms = [](clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+  };
+
+  auto result = summary();
+  fmt::print(out, "{:<32} {:>8} {:>12} {:>12} {:>12} {:>12}", "scope",
+             "calls", "total ms", "mean ms", "min ms", "max ms");
+  if constexpr (alloc::enabled()) {
+    fmt::print(out, " {:>10} {:>12} {:>12}", "allocs", "alloc bytes",
+               "peak bytes");
+  }
+  fmt::println(out, "");
+  for (auto const &s : result.scopes) {
+    fmt::print(out, "{:<32} {:>8} {:>12.3f} {:>12.3f} {:>12.3f} {:>12.3f}",
+               s.name, s.calls, ms(s.total), ms(s.total) / s.calls, ms(s.min),
+               ms(s.max));
+    if constexpr (alloc::enabled()) {
+      fmt::print(out, " {:>10} {:>12} {:>12}", s.allocations,
+                 s.allocated_bytes, s.peak_bytes);
+    }
+    fmt::println(out, "");
+  }
+  if (!result.counters.empty()) {
+    fmt::println(out, "{:<32} {:>12}", "counter", "value");
+    for (auto const &[name, value] : result.counters) {
+      fmt::println(out, "{:<32} {:>12}", name, value);
+    }
+  }
+}
+
+// trace event format, loads in chrome://tracing and Perfetto
+inline bool write_chrome_trace(std::string const &path) {
+  std::FILE *out = std::fopen(path.c_str(), "w");
+  if (!out) {
+    return false;
+  }
+
+  auto &g = detail::global();
+  std::lock_guard lock(g.mutex);
+
+  auto us = [&](clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  };
+
+  fmt::print(out, "{{\"traceEvents\": [");
+  char const *sep = "\n";
+  for (auto const &log : g.threads) {
+    clock::duration last{};
+    for (auto const &ev : log->events) {
+      fmt::print(out,
+                 "{}  {{\"name\": \"{}\", \"cat\": \"aoc\", \"ph\": \"X\", "
+                 "\"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}",
+                 sep, json_escape(ev.name), log->tid, us(ev.start - g.epoch),
+                 us(ev.elapsed));
+      if constexpr (alloc::enabled()) {
+        fmt::print(out,
+                   ", \"args\": {{\"allocations\": {}, \"bytes\": {}, "
+                   "\"peak_bytes\": {}}}",
+                   ev.heap.allocations, ev.heap.bytes, ev.heap.peak_bytes);
+      }
+      fmt::print(out, "}}");
+      last = std::max(last, ev.start + ev.elapsed - g.epoch);
+      sep = ",\n";
+    }
+    // counters only keep their final value, shown where the thread ended
+    for (auto const &[name, value] : log->counters) {
+      fmt::print(out,
+                 "{}  {{\"name\": \"{}\", \"ph\": \"C\", \"pid\": 1, "
+                 "\"tid\": {}, \"ts\": {:.3f}, \"args\": {{\"value\": {}}}}}",
+                 sep, json_escape(name), log->tid, us(last), value);
+      sep = ",\n";
+    }
+  }
+  fmt::print(out, "\n]}}\n");
+  std::fclose(out);
+  return true;
+}
+
+} // namespace aoc::instrument
+
+#define AOC_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define AOC_INSTRUMENT_CONCAT(a, b) AOC_INSTRUMENT_CONCAT_IMPL(a, b)
+
+#if AOC_INSTRUMENT
+#define AOC_SCOPE(name)                                                        \
+  ::aoc::instrument::scope AOC_INSTRUMENT_CONCAT(aoc_scope_, __LINE__) { name }
+#define AOC_COUNT(name, delta) ::aoc::instrument::count(name, delta)
+#else
+#define AOC_SCOPE(name) static_cast<void>(0)
+#define AOC_COUNT(name, delta) static_cast<void>(0)
+#endif
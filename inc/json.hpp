@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace aoc {
+
+// str as the body of a JSON string literal, control characters as \uXXXX
+inline std::string json_escape(std::string_view str) {
+  std::string out;
+  out.reserve(str.size());
+  for (char c : str) {
+    if (c == '"' or c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[7];
+      std::snprintf(buf, sizeof buf, "\\u%04x", static_cast<unsigned>(c));
+      out.append(buf, 6);
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+} // namespace aoc
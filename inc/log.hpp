@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <fmt/core.h>
+#include <string_view>
+#include <utility>
+
+// Diagnostics for the solvers, written to stderr so answers stay on stdout.
+//
+//   AOC_DEBUG("seeds: {}", seeds);
+//
+// AOC_LOG_LEVEL (0 trace .. 5 off) picks the lowest level that is compiled
+// in at all. It defaults to info so trace and debug calls vanish from the
+// hot loops, Debug builds ask for trace through CMake. Among the compiled in
+// levels the runtime verbosity decides what gets printed, warn and up by
+// default.
+//
+// The arguments are only evaluated when the message is printed, a call below
+// AOC_LOG_LEVEL leaves no code behind. Work done only for a message, like a
+// loop over a container, goes under
+// `if constexpr (aoc::log::compiled(level::trace))`.
+#ifndef AOC_LOG_LEVEL
+#define AOC_LOG_LEVEL 2
+#endif
+
+namespace aoc::log {
+
+enum class level { trace = 0, debug, info, warn, error, off };
+
+constexpr bool compiled(level lvl) {
+  return static_cast<int>(lvl) >= AOC_LOG_LEVEL;
+}
+
+inline std::atomic<level> &verbosity() {
+  static std::atomic<level> lvl{level::warn};
+  return lvl;
+}
+
+inline void set_verbosity(level lvl) {
+  verbosity().store(lvl, std::memory_order_relaxed);
+}
+
+inline bool enabled(level lvl) {
+  return lvl >= verbosity().load(std::memory_order_relaxed);
+}
+
+// "-v" -> info, "-vv" -> debug, "-vvv" -> trace
+inline bool parse_verbosity_flag(std::string_view arg) {
+  if (arg.size() < 2 or arg.size() > 4 or arg[0] != '-' or
+      arg.find_first_not_of('v', 1) != std::string_view::npos) {
+    return false;
+  }
+  set_verbosity(static_cast<level>(static_cast<int>(level::warn) -
+                                   static_cast<int>(arg.size() - 1)));
+  return true;
+}
+
+template <typename... Args>
+void print(fmt::format_string<Args...> fmt, Args &&...args) {
+  fmt::print(stderr, fmt, std::forward<Args>(args)...);
+  std::fputc('\n', stderr);
+}
+
+} // namespace aoc::log
+
+#define AOC_LOG(lvl, ...)                                                      \
+  do {                                                                         \
+    if constexpr (::aoc::log::compiled(lvl)) {                                 \
+      if (::aoc::log::enabled(lvl)) {                                          \
+        ::aoc::log::print(__VA_ARGS__);                                        \
+      }                                                                        \
+    }                                                                          \
+  } while (false)
+
+#define AOC_TRACE(...) AOC_LOG(::aoc::log::level::trace, __VA_ARGS__)
+#define AOC_DEBUG(...) AOC_LOG(::aoc::log::level::debug, __VA_ARGS__)
+#define AOC_INFO(...) AOC_LOG(::aoc::log::level::info, __VA_ARGS__)
+#define AOC_WARN(...) AOC_LOG(::aoc::log::level::warn, __VA_ARGS__)
+#define AOC_ERROR(...) AOC_LOG(::aoc::log::level::error, __VA_ARGS__)
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// splits on '\n' with std::getline semantics: a trailing newline does not
+// produce an extra empty line at the end
+struct line_range {
+
+  struct iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::string_view const *;
+    using reference = std::string_view;
+
+    iterator() = default;
+    iterator(std::string_view rest) : rest_(rest) { advance(); }
+
+    std::string_view operator*() const { return line_; }
+
+    iterator &operator++() {
+      advance();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp = *this;
+      advance();
+      return tmp;
+    }
+
+    bool operator==(iterator const &other) const {
+      return done_ == other.done_ and
+             (done_ or rest_.data() == other.rest_.data());
+    }
+
+  private:
+    void advance() {
+      if (rest_.empty()) {
+        done_ = true;
+        return;
+      }
+      auto eol = rest_.find('\n');
+      if (eol == std::string_view::npos) {
+        line_ = rest_;
+        rest_ = {};
+      } else {
+        line_ = rest_.substr(0, eol);
+        rest_.remove_prefix(eol + 1);
+      }
+    }
+
+    std::string_view rest_{};
+    std::string_view line_{};
+    bool done_{false};
+  };
+
+  iterator begin() const { return iterator(buf); }
+  iterator end() const {
+    iterator it;
+    ++it;
+    return it;
+  }
+
+  std::string_view buf;
+};
+
+// read-only view of the whole input file, lines are handed out as
+// string_views into the mapping so nothing gets copied
+struct mapped_file {
+
+  mapped_file() = default;
+
+  explicit mapped_file(std::filesystem::path const &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) == 0) {
+      size_ = static_cast<std::size_t>(st.st_size);
+      if (size_ == 0) {
+        // mmap refuses empty mappings, an empty file is still a valid input
+        good_ = true;
+      } else if (void *addr =
+                     ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                 addr != MAP_FAILED) {
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<char const *>(addr);
+        good_ = true;
+      }
+    }
+
+    ::close(fd);
+  }
+
+  mapped_file(mapped_file const &) = delete;
+  mapped_file &operator=(mapped_file const &) = delete;
+
+  mapped_file(mapped_file &&other) noexcept { swap(other); }
+
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    mapped_file tmp(std::move(other));
+    swap(tmp);
+    return *this;
+  }
+
+  ~mapped_file() {
+    if (data_) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+  }
+
+  bool good() const { return good_; }
+
+  std::string_view view() const { return {data_, data_ ? size_ : 0}; }
+
+  line_range lines() const { return {view()}; }
+
+private:
+  void swap(mapped_file &other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(good_, other.good_);
+  }
+
+  char const *data_{nullptr};
+  std::size_t size_{0};
+  bool good_{false};
+};
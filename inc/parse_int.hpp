@@ -0,0 +1,181 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Decimal integer parsing for the puzzle inputs.
+//
+//   scan_int<T>(str)         leading number of str and how many chars it took
+//   parse_int<T>(str)        just the value
+//   parse_ints<T>(line, out) every number of a line into a caller buffer
+//
+// Signed types accept a leading '-'. There is no overflow check, the inputs
+// are trusted. With SSE4.1 up to 16 digits are converted at once, with AVX2
+// the gaps between numbers are skipped 32 bytes at a time, the scalar code
+// covers everything else and the last bytes of a line.
+//
+// The vector paths are chosen at compile time from __SSE4_1__ / __AVX2__,
+// which the default x86-64 target defines neither of: configure with
+// -DAOC_NATIVE=ON (or pass a matching -march) to get them.
+namespace aoc {
+
+template <std::integral T> struct scanned {
+  T value{0};
+  // 0 when str does not start with a number
+  std::size_t length{0};
+};
+
+namespace detail {
+
+inline bool is_digit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+inline std::uint64_t digits_scalar(char const *p, std::size_t n) {
+  std::uint64_t val = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    val = val * 10 + static_cast<unsigned>(p[i] - '0');
+  }
+  return val;
+}
+
+#ifdef __SSE4_1__
+
+// number of leading digits in the 16 bytes at p, digits - '0' in `values`
+inline std::size_t digit_run16(char const *p, __m128i &values) {
+  auto chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+  values = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+  auto digits =
+      _mm_cmpeq_epi8(_mm_min_epu8(values, _mm_set1_epi8(9)), values);
+  auto non_digits = ~static_cast<unsigned>(_mm_movemask_epi8(digits));
+  return std::countr_zero(non_digits | 0x10000u);
+}
+
+// the first n <= 16 of the digit values as one number
+inline std::uint64_t digits16(__m128i values, std::size_t n) {
+  // right align the digits, shuffle indices below zero clear the byte
+  auto index = _mm_add_epi8(
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+      _mm_set1_epi8(static_cast<char>(n - 16)));
+  auto v = _mm_shuffle_epi8(values, index);
+  // pairs, quads, octets
+  v = _mm_maddubs_epi16(v, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10,
+                                         1, 10, 1, 10, 1));
+  v = _mm_madd_epi16(v, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  v = _mm_packus_epi32(v, v);
+  v = _mm_madd_epi16(v, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  auto high = static_cast<std::uint32_t>(_mm_cvtsi128_si32(v));
+  auto low = static_cast<std::uint32_t>(_mm_extract_epi32(v, 1));
+  return high * std::uint64_t{100000000} + low;
+}
+
+#endif
+
+// first digit at or after pos, str.size() if there is none
+inline std::size_t find_digit(std::string_view str, std::size_t pos) {
+  if (pos < str.size() and is_digit(str[pos])) {
+    return pos;
+  }
+#ifdef __AVX2__
+  for (; pos + 32 <= str.size(); pos += 32) {
+    auto chunk =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const *>(str.data() + pos));
+    auto values = _mm256_sub_epi8(chunk, _mm256_set1_epi8('0'));
+    auto digits = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(values, _mm256_set1_epi8(9)), values);
+    if (auto mask = static_cast<unsigned>(_mm256_movemask_epi8(digits))) {
+      return pos + std::countr_zero(mask);
+    }
+  }
+#endif
+  while (pos < str.size() and !is_digit(str[pos])) {
+    ++pos;
+  }
+  return pos;
+}
+
+// value and length of the digit run at the start of str
+inline std::pair<std::uint64_t, std::size_t> scan_digits(std::string_view str) {
+#ifdef __SSE4_1__
+  if (str.size() >= 16) {
+    __m128i values;
+    auto n = digit_run16(str.data(), values);
+    if (n < 16 or str.size() == 16 or !is_digit(str[16])) {
+      return {digits16(values, n), n};
+    }
+  }
+#endif
+  std::size_t n = 0;
+  while (n < str.size() and is_digit(str[n])) {
+    ++n;
+  }
+  return {digits_scalar(str.data(), n), n};
+}
+
+} // namespace detail
+
+template <std::integral T> scanned<T> scan_int(std::string_view str) {
+  bool negative = false;
+  std::size_t sign = 0;
+  if constexpr (std::is_signed_v<T>) {
+    if (!str.empty() and str.front() == '-') {
+      negative = true;
+      sign = 1;
+    }
+  }
+
+  auto [magnitude, n] = detail::scan_digits(str.substr(sign));
+  if (n == 0) {
+    return {};
+  }
+  auto value = static_cast<T>(magnitude);
+  return {negative ? static_cast<T>(-value) : value, sign + n};
+}
+
+template <std::integral T> T parse_int(std::string_view str) {
+  return scan_int<T>(str).value;
+}
+
+// Writes the numbers of line to out until either runs out, returns how many
+// were written. Anything that cannot start a number separates them.
+template <std::integral T>
+std::size_t parse_ints(std::string_view line, std::span<T> out) {
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  while (count < out.size()) {
+    pos = detail::find_digit(line, pos);
+    if (pos == line.size()) {
+      break;
+    }
+    auto [magnitude, n] = detail::scan_digits(line.substr(pos));
+    auto value = static_cast<T>(magnitude);
+    if constexpr (std::is_signed_v<T>) {
+      if (pos > 0 and line[pos - 1] == '-') {
+        value = -value;
+      }
+    }
+    out[count++] = value;
+    pos += n;
+  }
+  return count;
+}
+
+// every number of line, sized for the densest possible line
+template <std::integral T> std::vector<T> parse_ints(std::string_view line) {
+  std::vector<T> out((line.size() + 1) / 2);
+  out.resize(parse_ints(line, std::span<T>(out)));
+  return out;
+}
+
+} // namespace aoc
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "log.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/core.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware counters around a block of code, through perf_event_open.
+//
+// Only the calling thread is counted, kernel time is excluded so the default
+// perf_event_paranoid setting is enough. Events the CPU or the kernel refuses
+// are reported as missing, without a usable cycle counter the whole group is
+// unavailable and start() / stop() do nothing.
+namespace aoc::perf {
+
+enum class event {
+  cycles,
+  instructions,
+  l1d_misses,
+  llc_misses,
+  branch_misses,
+};
+
+inline constexpr std::size_t event_count = 5;
+
+inline constexpr std::array<std::string_view, event_count> event_names = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"};
+
+struct readings {
+  std::array<std::optional<std::uint64_t>, event_count> values;
+
+  std::optional<std::uint64_t> operator[](event e) const {
+    return values[static_cast<std::size_t>(e)];
+  }
+
+  std::optional<double> ipc() const {
+    auto cycles = (*this)[event::cycles];
+    auto instructions = (*this)[event::instructions];
+    if (!cycles or !instructions or *cycles == 0) {
+      return std::nullopt;
+    }
+    return static_cast<double>(*instructions) / *cycles;
+  }
+};
+
+inline std::string describe(readings const &r) {
+  std::string out;
+  for (std::size_t i = 0; i < event_count; ++i) {
+    if (r.values[i]) {
+      out += fmt::format("{}{} {}", out.empty() ? "" : "  ", event_names[i],
+                         *r.values[i]);
+    }
+  }
+  if (auto ipc = r.ipc()) {
+    out += fmt::format("  ipc {:.2f}", *ipc);
+  }
+  return out;
+}
+
+#ifdef __linux__
+
+class counter_group {
+public:
+  counter_group() {
+    struct spec {
+      event which;
+      std::uint32_t type;
+      std::uint64_t config;
+    };
+    // the leader comes first, the group is unusable without it
+    static constexpr std::array<spec, event_count> specs = {{
+        {event::cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {event::instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {event::l1d_misses, PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {event::llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {event::branch_misses, PERF_TYPE_HARDWARE,
+         PERF_COUNT_HW_BRANCH_MISSES},
+    }};
+
+    for (auto const &s : specs) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = s.type;
+      attr.config = s.config;
+      attr.disabled = leader < 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      int fd = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+      if (fd < 0) {
+        if (leader < 0) {
+          AOC_WARN("hardware counters unavailable: {}", std::strerror(errno));
+          return;
+        }
+        AOC_INFO("{} counter unavailable: {}",
+                 event_names[static_cast<std::size_t>(s.which)],
+                 std::strerror(errno));
+        continue;
+      }
+      if (leader < 0) {
+        leader = fd;
+      }
+      members.push_back({s.which, fd});
+    }
+  }
+
+  ~counter_group() {
+    for (auto const &m : members) {
+      close(m.fd);
+    }
+  }
+
+  counter_group(counter_group const &) = delete;
+  counter_group &operator=(counter_group const &) = delete;
+
+  bool available() const { return leader >= 0; }
+
+  void start() {
+    if (available()) {
+      ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  readings stop() {
+    readings result;
+    if (!available()) {
+      return result;
+    }
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time enabled, time running, one value per member
+    std::array<std::uint64_t, 3 + event_count> buf{};
+    auto bytes = read(leader, buf.data(), sizeof(buf));
+    auto nr = buf[0];
+    auto enabled = buf[1];
+    auto running = buf[2];
+    if (bytes < 0 or nr != members.size() or running == 0) {
+      return result;
+    }
+
+    // the kernel multiplexes when the group does not fit the PMU, scale up
+    double scale = static_cast<double>(enabled) / running;
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      result.values[static_cast<std::size_t>(members[i].which)] =
+          static_cast<std::uint64_t>(buf[3 + i] * scale);
+    }
+    return result;
+  }
+
+private:
+  struct member {
+    event which;
+    int fd;
+  };
+
+  int leader{-1};
+  std::vector<member> members;
+};
+
+#else
+
+class counter_group {
+public:
+  counter_group() {
+    AOC_WARN("hardware counters are only supported on linux");
+  }
+
+  bool available() const { return false; }
+  void start() {}
+  readings stop() { return {}; }
+};
+
+#endif
+
+} // namespace aoc::perf
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// A function on [0, inf) that shifts every interval of a sorted set of
+// breakpoints by its own offset, value -> value + offset of the piece holding
+// it. Translation tables like the day5 almanac maps are such functions, and
+// so is any chain of them, so a chain can be composed into one table:
+//
+//   auto location = aoc::piecewise_map::from_rules(seed_to_soil)
+//                       .then(aoc::piecewise_map::from_rules(soil_to_...));
+//   location(seed);                  one binary search
+//   location.min_image(first, last); walks only the pieces inside the range
+namespace aoc {
+
+class piecewise_map {
+public:
+  using value_t = std::int64_t;
+
+  // [from, from + len) -> [to, to + len)
+  struct rule {
+    value_t to;
+    value_t from;
+    value_t len;
+  };
+
+  // the identity
+  piecewise_map() : pieces{{0, 0}} {}
+
+  // values outside every rule map to themselves, rules must not overlap
+  static piecewise_map from_rules(std::span<rule const> rules) {
+    std::vector<rule> sorted(rules.begin(), rules.end());
+    std::ranges::sort(sorted, {}, &rule::from);
+
+    piecewise_map map;
+    map.pieces.clear();
+    value_t covered = 0;
+    for (auto const &r : sorted) {
+      if (r.len <= 0) {
+        continue;
+      }
+      if (r.from > covered) {
+        map.push({covered, 0});
+      }
+      map.push({r.from, r.to - r.from});
+      covered = r.from + r.len;
+    }
+    map.push({covered, 0});
+    return map;
+  }
+
+  value_t operator()(value_t value) const {
+    return value + pieces[piece_at(value)].offset;
+  }
+
+  // this map followed by next: every piece is cut where its image crosses a
+  // breakpoint of next, neighbours that end up with one offset are merged
+  piecewise_map then(piecewise_map const &next) const {
+    piecewise_map composed;
+    composed.pieces.clear();
+    for (std::size_t i = 0; i < pieces.size(); ++i) {
+      auto begin = pieces[i].start;
+      auto end = i + 1 < pieces.size() ? pieces[i + 1].start : unbounded;
+      auto shift = pieces[i].offset;
+
+      for (auto j = next.piece_at(begin + shift); j < next.pieces.size();
+           ++j) {
+        // where next's piece j starts, seen from this map's side
+        auto cut = std::max(begin, next.pieces[j].start - shift);
+        if (cut >= end) {
+          break;
+        }
+        composed.push({cut, shift + next.pieces[j].offset});
+      }
+    }
+    return composed;
+  }
+
+  // smallest value the inclusive range [first, last] maps to, the lowest
+  // value of each piece overlapping it is a candidate as pieces only shift
+  value_t min_image(value_t first, value_t last) const {
+    auto i = piece_at(first);
+    auto best = first + pieces[i].offset;
+    for (++i; i < pieces.size() and pieces[i].start <= last; ++i) {
+      best = std::min(best, pieces[i].start + pieces[i].offset);
+    }
+    return best;
+  }
+
+  std::size_t size() const { return pieces.size(); }
+
+private:
+  struct piece {
+    value_t start;
+    value_t offset;
+  };
+
+  static constexpr value_t unbounded = std::numeric_limits<value_t>::max();
+
+  // index of the piece holding value, the last one starting at or before
+  // it: a branch free binary search, every step halves the range with a
+  // conditional move instead of a jump the predictor cannot guess
+  std::size_t piece_at(value_t value) const {
+    auto const *base = pieces.data();
+    auto len = pieces.size();
+    while (len > 1) {
+      auto half = len / 2;
+      base = base[half].start <= value ? base + half : base;
+      len -= half;
+    }
+    return base - pieces.data();
+  }
+
+  void push(piece p) {
+    if (!pieces.empty() and pieces.back().offset == p.offset) {
+      return;
+    }
+    pieces.push_back(p);
+  }
+
+  // sorted by start, the first starts at 0
+  std::vector<piece> pieces;
+};
+
+} // namespace aoc
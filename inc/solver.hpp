@@ -0,0 +1,110 @@
+#pragma once
+
+#include "args.hpp"
+#include <filesystem>
+#include <fmt/core.h>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+
+// a solution is a plain struct with
+//   void parse(std::string_view input);
+//   <formattable> part1();   (optional)
+//   <formattable> part2();   (optional)
+//   std::optional<<range of formattable>> queries();   (optional)
+// and either a default constructor or one taking the extra command line
+// parameters (args_t). A fresh instance is created for every run.
+// queries() answers extra questions asked through the parameters, nullopt
+// when none were asked; the runner prints the answers after its report.
+struct solution_base {
+  virtual ~solution_base() = default;
+
+  virtual void parse(std::string_view input) = 0;
+  virtual std::optional<std::string> part1() = 0;
+  virtual std::optional<std::string> part2() = 0;
+  virtual std::optional<std::vector<std::string>> queries() = 0;
+};
+
+template <typename Solution> struct solution_model final : solution_base {
+
+  explicit solution_model(args_t const &params) : impl(make(params)) {}
+
+  void parse(std::string_view input) override { impl.parse(input); }
+
+  std::optional<std::string> part1() override {
+    if constexpr (requires { impl.part1(); }) {
+      return fmt::format("{}", impl.part1());
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  std::optional<std::string> part2() override {
+    if constexpr (requires { impl.part2(); }) {
+      return fmt::format("{}", impl.part2());
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  std::optional<std::vector<std::string>> queries() override {
+    if constexpr (requires { impl.queries(); }) {
+      auto answers = impl.queries();
+      if (!answers) {
+        return std::nullopt;
+      }
+      std::vector<std::string> formatted;
+      formatted.reserve(std::size(*answers));
+      for (auto const &answer : *answers) {
+        formatted.push_back(fmt::format("{}", answer));
+      }
+      return formatted;
+    } else {
+      return std::nullopt;
+    }
+  }
+
+private:
+  static Solution make(args_t const &params) {
+    if constexpr (std::is_constructible_v<Solution, args_t const &>) {
+      return Solution(params);
+    } else {
+      return Solution{};
+    }
+  }
+
+  Solution impl;
+};
+
+struct solver_info {
+  std::string name;
+  // relative to the repository root
+  std::filesystem::path default_input;
+  std::function<std::unique_ptr<solution_base>(args_t const &)> make;
+};
+
+inline std::vector<solver_info> &registry() {
+  static std::vector<solver_info> solvers;
+  return solvers;
+}
+
+// meant to initialize a namespace scope variable in the day's source, e.g.
+//   bool const registered = aoc::register_solver<solution>("day4", ...);
+template <typename Solution>
+bool register_solver(std::string name, std::filesystem::path default_input) {
+  registry().push_back({std::move(name), std::move(default_input),
+                        [](args_t const &params) {
+                          return std::make_unique<solution_model<Solution>>(
+                              params);
+                        }});
+  return true;
+}
+
+} // namespace aoc
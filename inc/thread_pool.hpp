@@ -0,0 +1,262 @@
+#pragma once
+
+#include "args.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fmt/core.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+
+// Work stealing pool. Every thread owns a queue, takes its own work from the
+// back and steals from the front of the others once it runs dry. The thread
+// calling for_each_index() counts as one of the threads and helps until its
+// batch is done, batches are not meant to be submitted from inside a task.
+class thread_pool {
+public:
+  explicit thread_pool(std::size_t threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    for (std::size_t i = 0; i < threads; ++i) {
+      queues.push_back(std::make_unique<queue>());
+    }
+    for (std::size_t i = 1; i < threads; ++i) {
+      workers.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  ~thread_pool() {
+    {
+      std::lock_guard lock(sleep_mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  thread_pool(thread_pool const &) = delete;
+  thread_pool &operator=(thread_pool const &) = delete;
+
+  std::size_t size() const { return queues.size(); }
+
+  // calls fn(i) for every i in [0, n) and returns once all calls finished.
+  // The first exception thrown by fn is rethrown here after the whole batch
+  // has drained, calls that did not start yet are skipped.
+  template <typename Fn> void for_each_index(std::size_t n, Fn &&fn) {
+    std::atomic<std::size_t> remaining{n};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    for (std::size_t i = 0; i < n; ++i) {
+      auto &q = *queues[i % queues.size()];
+      std::lock_guard lock(q.mutex);
+      q.tasks.emplace_back([&, i] {
+        if (!failed.load(std::memory_order_relaxed)) {
+          try {
+            fn(i);
+          } catch (...) {
+            std::lock_guard lock(error_mutex);
+            if (!error) {
+              error = std::current_exception();
+            }
+            failed.store(true, std::memory_order_relaxed);
+          }
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+      });
+    }
+    {
+      std::lock_guard lock(sleep_mutex);
+      pending.fetch_add(n, std::memory_order_relaxed);
+    }
+    wake.notify_all();
+
+    while (remaining.load(std::memory_order_acquire) != 0) {
+      if (!run_one(0)) {
+        std::this_thread::yield();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+private:
+  using task = std::function<void()>;
+
+  struct queue {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  std::optional<task> take(std::size_t self) {
+    {
+      auto &own = *queues[self];
+      std::lock_guard lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task t = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return t;
+      }
+    }
+    for (std::size_t k = 1; k < queues.size(); ++k) {
+      auto &victim = *queues[(self + k) % queues.size()];
+      std::lock_guard lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task t = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return t;
+      }
+    }
+    return std::nullopt;
+  }
+
+  bool run_one(std::size_t self) {
+    auto t = take(self);
+    if (!t) {
+      return false;
+    }
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    (*t)();
+    return true;
+  }
+
+  void work(std::size_t self) {
+    while (true) {
+      if (run_one(self)) {
+        continue;
+      }
+      std::unique_lock lock(sleep_mutex);
+      wake.wait(lock, [this] {
+        return stopping or pending.load(std::memory_order_relaxed) != 0;
+      });
+      if (stopping) {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<queue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  std::atomic<std::size_t> pending{0};
+  bool stopping{false};
+};
+
+// "--threads N" among the solver params, N > 0, without the option the
+// solver stays single threaded; anything but a positive count throws
+inline std::size_t thread_count(args_t const &params) {
+  auto str = option(params, "--threads");
+  if (!str) {
+    return 1;
+  }
+  std::size_t threads = 0;
+  auto [end, ec] =
+      std::from_chars(str->data(), str->data() + str->size(), threads);
+  if (ec != std::errc{} or end != str->data() + str->size() or threads == 0) {
+    throw std::invalid_argument(
+        fmt::format("--threads expects a positive count, got '{}'", *str));
+  }
+  return threads;
+}
+
+// nullptr for a single thread, the reductions below then run inline
+inline std::unique_ptr<thread_pool> make_pool(args_t const &params) {
+  auto threads = thread_count(params);
+  return threads > 1 ? std::make_unique<thread_pool>(threads) : nullptr;
+}
+
+// splits input into about `parts` pieces, each ending after a '\n'
+inline std::vector<std::string_view> split_lines(std::string_view input,
+                                                 std::size_t parts) {
+  std::vector<std::string_view> chunks;
+  std::size_t target = input.size() / std::max<std::size_t>(parts, 1) + 1;
+  while (!input.empty()) {
+    auto end = input.find('\n', std::min(target, input.size()) - 1);
+    end = end == std::string_view::npos ? input.size() : end + 1;
+    chunks.push_back(input.substr(0, end));
+    input.remove_prefix(end);
+  }
+  return chunks;
+}
+
+// fn(i) for every i in [0, n), inline without a pool
+template <typename Fn>
+void parallel_for(thread_pool *pool, std::size_t n, Fn &&fn) {
+  if (!pool or pool->size() == 1 or n < 2) {
+    for (std::size_t i = 0; i < n; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  pool->for_each_index(n, fn);
+}
+
+// fold over [0, n): map(begin, end) handles a block of indices, the block
+// results are combined in index order so non commutative combines work
+template <typename Acc, typename Map, typename Combine>
+Acc parallel_reduce(thread_pool *pool, std::size_t n, Acc init, Map map,
+                    Combine combine) {
+  if (!pool or pool->size() == 1 or n < 2) {
+    return combine(std::move(init), map(std::size_t{0}, n));
+  }
+
+  using result_t = std::invoke_result_t<Map &, std::size_t, std::size_t>;
+  std::size_t blocks = std::min(n, pool->size() * 4);
+  std::vector<std::optional<result_t>> partial(blocks);
+  pool->for_each_index(blocks, [&](std::size_t b) {
+    partial[b] = map(n * b / blocks, n * (b + 1) / blocks);
+  });
+
+  for (auto &p : partial) {
+    init = combine(std::move(init), std::move(*p));
+  }
+  return init;
+}
+
+// fold over the lines of input: map(chunk) handles a run of whole lines,
+// chunk results are combined in input order
+template <typename Acc, typename Map, typename Combine>
+Acc parallel_reduce_lines(thread_pool *pool, std::string_view input, Acc init,
+                          Map map, Combine combine) {
+  if (!pool or pool->size() == 1 or input.empty()) {
+    return combine(std::move(init), map(input));
+  }
+
+  auto chunks = split_lines(input, pool->size() * 4);
+  return parallel_reduce(
+      pool, chunks.size(), std::move(init),
+      [&](std::size_t begin, std::size_t end) {
+        auto first = chunks[begin].data();
+        auto last = chunks[end - 1].data() + chunks[end - 1].size();
+        return map(std::string_view(first, last - first));
+      },
+      combine);
+}
+
+// combine for reductions collecting per line results in input order
+inline constexpr auto append = [](auto acc, auto &&part) {
+  acc.insert(acc.end(), std::make_move_iterator(part.begin()),
+             std::make_move_iterator(part.end()));
+  return acc;
+};
+
+} // namespace aoc
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <range/v3/view/interface.hpp>
+#include <string_view>
+#include <utility>
+
+// Splits a string_view into string_view tokens on the fly, the tokens point
+// into the input and nothing is allocated.
+//
+//   for (std::string_view num : aoc::tokenize(line, " ")) ...
+//   aoc::tokenize("a,,b", ",", aoc::empty_tokens::keep) -> "a" "" "b"
+//
+// Any character of `delims` ends a token. Empty tokens (delimiter runs,
+// leading or trailing delimiters) are skipped unless asked to keep them,
+// an empty input has no tokens either way.
+namespace aoc {
+
+enum class empty_tokens { skip, keep };
+
+class token_iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::string_view;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::string_view;
+  using pointer = void;
+
+  // the end iterator
+  token_iterator() = default;
+
+  token_iterator(std::string_view input, std::string_view delims,
+                 empty_tokens mode)
+      : rest(input), delims(delims), mode(mode), exhausted(input.empty()),
+        at_end(false) {
+    next();
+  }
+
+  std::string_view operator*() const { return current; }
+
+  token_iterator &operator++() {
+    next();
+    return *this;
+  }
+
+  token_iterator operator++(int) {
+    auto prev = *this;
+    next();
+    return prev;
+  }
+
+  bool operator==(token_iterator const &other) const {
+    return at_end == other.at_end and
+           (at_end or current.data() == other.current.data());
+  }
+
+private:
+  void next() {
+    do {
+      if (exhausted) {
+        at_end = true;
+        return;
+      }
+      auto stop = delims.size() == 1 ? rest.find(delims.front())
+                                     : rest.find_first_of(delims);
+      if (stop == std::string_view::npos) {
+        current = rest;
+        exhausted = true;
+      } else {
+        current = rest.substr(0, stop);
+        rest.remove_prefix(stop + 1);
+      }
+    } while (mode == empty_tokens::skip and current.empty());
+  }
+
+  std::string_view rest;
+  std::string_view current;
+  std::string_view delims;
+  empty_tokens mode{empty_tokens::skip};
+  bool exhausted{true};
+  bool at_end{true};
+};
+
+class token_range : public ranges::view_interface<token_range> {
+public:
+  token_range() = default;
+  token_range(std::string_view input, std::string_view delims,
+              empty_tokens mode)
+      : input(input), delims(delims), mode(mode) {}
+
+  token_iterator begin() const { return {input, delims, mode}; }
+  token_iterator end() const { return {}; }
+
+private:
+  std::string_view input;
+  std::string_view delims;
+  empty_tokens mode{empty_tokens::skip};
+};
+
+inline token_range tokenize(std::string_view input,
+                            std::string_view delims = " ",
+                            empty_tokens mode = empty_tokens::skip) {
+  return {input, delims, mode};
+}
+
+// the first N tokens, missing ones are left empty
+template <std::size_t N>
+std::array<std::string_view, N>
+first_tokens(std::string_view input, std::string_view delims = " ",
+             empty_tokens mode = empty_tokens::skip) {
+  std::array<std::string_view, N> out{};
+  auto it = out.begin();
+  for (std::string_view token : tokenize(input, delims, mode)) {
+    if (it == out.end()) {
+      break;
+    }
+    *it++ = token;
+  }
+  return out;
+}
+
+// text before and after the first delim, the whole input and an empty
+// remainder when there is none
+inline std::pair<std::string_view, std::string_view>
+split_once(std::string_view input, char delim) {
+  auto at = input.find(delim);
+  if (at == std::string_view::npos) {
+    return {input, {}};
+  }
+  return {input.substr(0, at), input.substr(at + 1)};
+}
+
+} // namespace aoc
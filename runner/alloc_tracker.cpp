@@ -0,0 +1,129 @@
+// replaces the global operator new / delete to feed inc/alloc_tracker.hpp,
+// linked into the executables with -DAOC_TRACK_ALLOCS=ON
+#include "alloc_tracker.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// every block carries its size in front, unsized deletes need it for the
+// live byte count, over-aligned blocks put it in front of a whole alignment
+constexpr std::size_t header = alignof(std::max_align_t);
+
+std::size_t offset_for(std::size_t align) { return std::max(header, align); }
+
+void *allocate(std::size_t size,
+               std::size_t align = alignof(std::max_align_t)) noexcept {
+  auto offset = offset_for(align);
+  void *raw = nullptr;
+  if (align <= header) {
+    raw = std::malloc(size + offset);
+  } else {
+    // aligned_alloc wants a multiple of the alignment
+    auto rounded = (size + offset + align - 1) / align * align;
+    raw = std::aligned_alloc(align, rounded);
+  }
+  if (!raw) {
+    return nullptr;
+  }
+  auto *base = static_cast<std::byte *>(raw);
+  *reinterpret_cast<std::size_t *>(base) = size;
+  aoc::alloc::on_alloc(size);
+  return base + offset;
+}
+
+void release(void *ptr,
+             std::size_t align = alignof(std::max_align_t)) noexcept {
+  if (!ptr) {
+    return;
+  }
+  auto *base = static_cast<std::byte *>(ptr) - offset_for(align);
+  aoc::alloc::on_free(*reinterpret_cast<std::size_t *>(base));
+  std::free(base);
+}
+
+std::size_t value_of(std::align_val_t align) {
+  return static_cast<std::size_t>(align);
+}
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  if (void *ptr = allocate(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept {
+  return allocate(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+  if (void *ptr = allocate(size, value_of(align))) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return ::operator new(size, align);
+}
+
+void *operator new(std::size_t size, std::align_val_t align,
+                   std::nothrow_t const &) noexcept {
+  return allocate(size, value_of(align));
+}
+
+void *operator new[](std::size_t size, std::align_val_t align,
+                     std::nothrow_t const &) noexcept {
+  return allocate(size, value_of(align));
+}
+
+void operator delete(void *ptr) noexcept { release(ptr); }
+void operator delete[](void *ptr) noexcept { release(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { release(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { release(ptr); }
+
+void operator delete(void *ptr, std::nothrow_t const &) noexcept {
+  release(ptr);
+}
+
+void operator delete[](void *ptr, std::nothrow_t const &) noexcept {
+  release(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t align) noexcept {
+  release(ptr, value_of(align));
+}
+
+void operator delete[](void *ptr, std::align_val_t align) noexcept {
+  release(ptr, value_of(align));
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t align) noexcept {
+  release(ptr, value_of(align));
+}
+
+void operator delete[](void *ptr, std::size_t,
+                       std::align_val_t align) noexcept {
+  release(ptr, value_of(align));
+}
+
+void operator delete(void *ptr, std::align_val_t align,
+                     std::nothrow_t const &) noexcept {
+  release(ptr, value_of(align));
+}
+
+void operator delete[](void *ptr, std::align_val_t align,
+                       std::nothrow_t const &) noexcept {
+  release(ptr, value_of(align));
+}
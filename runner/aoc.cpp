@@ -0,0 +1,134 @@
+// runs any subset of the registered solvers in a single process
+#include "args.hpp"
+#include "instrument.hpp"
+#include "log.hpp"
+#include "perf_counters.hpp"
+#include "runner.hpp"
+#include "solver.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fmt/core.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage(std::string_view self) {
+  fmt::println("usage: {} [-v...] [--root <dir>] [--input <file>] [--list] "
+               "[--profile] [--trace <file>] [--perf] [all | <day>...] "
+               "[-- <params>...]",
+               std::filesystem::path(self).filename().string());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  auto args = parse_args(argc, argv);
+
+  std::filesystem::path root = ".";
+  std::optional<std::filesystem::path> input;
+  std::vector<std::string_view> selectors;
+  args_t params;
+  std::optional<std::string> trace;
+  bool list = false;
+  bool profile = false;
+  bool perf = false;
+
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    if (args[i] == "--root" and i + 1 < args.size()) {
+      root = args[++i];
+    } else if (args[i] == "--input" and i + 1 < args.size()) {
+      input = args[++i];
+    } else if (args[i] == "--list") {
+      list = true;
+    } else if (args[i] == "--profile") {
+      profile = true;
+    } else if (args[i] == "--perf") {
+      perf = true;
+    } else if (args[i] == "--trace" and i + 1 < args.size()) {
+      trace = args[++i];
+    } else if (aoc::log::parse_verbosity_flag(args[i])) {
+      continue;
+    } else if (args[i] == "--") {
+      params.assign(args.begin() + i + 1, args.end());
+      break;
+    } else if (args[i].starts_with("-")) {
+      usage(args[0]);
+      return -1;
+    } else {
+      selectors.push_back(args[i]);
+    }
+  }
+
+  if (selectors.empty()) {
+    selectors.push_back("all");
+  }
+
+  std::vector<aoc::solver_info const *> selected;
+  for (auto const &solver : aoc::registry()) {
+    if (std::ranges::any_of(selectors, [&](std::string_view sel) {
+          return aoc::runner::matches(solver.name, sel);
+        })) {
+      selected.push_back(&solver);
+    }
+  }
+
+  std::ranges::sort(selected, [](auto const *l, auto const *r) {
+    return aoc::runner::natural_less(l->name, r->name);
+  });
+
+  if (list) {
+    for (auto const *solver : selected) {
+      fmt::println("{} ({})", solver->name, solver->default_input.string());
+    }
+    return 0;
+  }
+
+  if (selected.empty()) {
+    fmt::println("no solver matches the selection");
+    return -1;
+  }
+
+  if (input and selected.size() != 1) {
+    fmt::println("--input needs exactly one selected solver, got {}",
+                 selected.size());
+    return -1;
+  }
+
+  aoc::instrument::set_enabled(profile or trace);
+
+  std::optional<aoc::perf::counter_group> counters;
+  if (perf) {
+    counters.emplace();
+  }
+
+  int failed = 0;
+  aoc::runner::clock::duration total{};
+
+  for (auto const *solver : selected) {
+    auto path = input ? *input : root / solver->default_input;
+    auto result = aoc::runner::run(*solver, path, params,
+                                   counters ? &*counters : nullptr);
+    if (!result) {
+      ++failed;
+      continue;
+    }
+    aoc::runner::report(*solver, *result);
+    total += result->total();
+  }
+
+  fmt::println("{} solvers in {:.3f} ms", selected.size() - failed,
+               aoc::runner::as_ms(total));
+
+  if (profile) {
+    aoc::instrument::write_summary(stdout);
+  }
+  if (trace and !aoc::instrument::write_chrome_trace(*trace)) {
+    fmt::println("cannot open file: {}", *trace);
+    ++failed;
+  }
+
+  return failed ? -1 : 0;
+}
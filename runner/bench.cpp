@@ -0,0 +1,298 @@
+// repeatedly runs the registered solvers and reports per phase statistics
+#include "alloc_tracker.hpp"
+#include "args.hpp"
+#include "json.hpp"
+#include "mapped_file.hpp"
+#include "runner.hpp"
+#include "solver.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fmt/core.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using aoc::runner::clock;
+
+struct phase_samples {
+  std::string_view name;
+  std::vector<clock::duration> elapsed;
+  std::size_t allocations{0};
+  std::size_t allocated_bytes{0};
+  std::size_t peak_bytes{0};
+};
+
+struct bench_result {
+  std::string solver;
+  std::filesystem::path input;
+  std::size_t input_bytes{0};
+  std::vector<phase_samples> phases;
+};
+
+struct summary {
+  clock::duration min;
+  clock::duration median;
+  clock::duration p99;
+};
+
+// nearest rank percentiles
+summary summarize(std::vector<clock::duration> samples) {
+  std::ranges::sort(samples);
+  auto at = [&](double pct) {
+    auto rank = static_cast<std::size_t>(pct * samples.size() + 0.999999);
+    return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+  };
+  return {samples.front(), at(0.5), at(0.99)};
+}
+
+phase_samples &samples_of(bench_result &result, std::string_view phase) {
+  auto it = std::ranges::find(result.phases, phase, &phase_samples::name);
+  if (it == result.phases.end()) {
+    return result.phases.emplace_back(phase_samples{phase, {}, 0, 0, 0});
+  }
+  return *it;
+}
+
+template <typename Fn>
+void measure(bench_result &result, std::string_view phase, Fn &&fn) {
+  clock::duration elapsed;
+  aoc::alloc::usage used;
+  if constexpr (aoc::alloc::enabled()) {
+    aoc::alloc::window heap;
+    elapsed = aoc::runner::timed(fn);
+    used = heap.close();
+  } else {
+    elapsed = aoc::runner::timed(fn);
+  }
+
+  auto &samples = samples_of(result, phase);
+  samples.elapsed.push_back(elapsed);
+  samples.allocations += used.allocations;
+  samples.allocated_bytes += used.bytes;
+  samples.peak_bytes = std::max(samples.peak_bytes, used.peak_bytes);
+}
+
+std::optional<bench_result> bench(aoc::solver_info const &solver,
+                                  std::filesystem::path const &path,
+                                  args_t const &params, int iterations) {
+  mapped_file input(path);
+  if (!input.good()) {
+    return std::nullopt;
+  }
+
+  bench_result result{solver.name, path, input.view().size(), {}};
+
+  for (int i = 0; i < iterations; ++i) {
+    auto solution = solver.make(params);
+    bool has_part1 = false;
+    bool has_part2 = false;
+    bool has_query = false;
+
+    measure(result, "parse", [&] { solution->parse(input.view()); });
+    measure(result, "part1",
+            [&] { has_part1 = solution->part1().has_value(); });
+    measure(result, "part2",
+            [&] { has_part2 = solution->part2().has_value(); });
+    measure(result, "query",
+            [&] { has_query = solution->queries().has_value(); });
+
+    // parts the solver does not implement are dropped after the first round
+    if (!has_part1 or !has_part2 or !has_query) {
+      std::erase_if(result.phases, [&](auto const &p) {
+        return (p.name == "part1" and !has_part1) or
+               (p.name == "part2" and !has_part2) or
+               (p.name == "query" and !has_query);
+      });
+    }
+  }
+
+  return result;
+}
+
+clock::duration median_total(bench_result const &result) {
+  clock::duration total{};
+  for (auto const &phase : result.phases) {
+    total += summarize(phase.elapsed).median;
+  }
+  return total;
+}
+
+double bytes_per_second(bench_result const &result) {
+  auto seconds = std::chrono::duration<double>(median_total(result)).count();
+  return seconds > 0 ? result.input_bytes / seconds : 0.0;
+}
+
+void report(bench_result const &result, int iterations) {
+  fmt::println("{} ({}, {} bytes)", result.solver, result.input.string(),
+               result.input_bytes);
+  fmt::print("  {:<6} {:>12} {:>12} {:>12}", "phase", "min ms", "median ms",
+             "p99 ms");
+  if constexpr (aoc::alloc::enabled()) {
+    fmt::print(" {:>10} {:>12} {:>12}", "allocs", "alloc bytes", "peak bytes");
+  }
+  fmt::println("");
+  for (auto const &phase : result.phases) {
+    auto stats = summarize(phase.elapsed);
+    fmt::print("  {:<6} {:>12.3f} {:>12.3f} {:>12.3f}", phase.name,
+               aoc::runner::as_ms(stats.min), aoc::runner::as_ms(stats.median),
+               aoc::runner::as_ms(stats.p99));
+    if constexpr (aoc::alloc::enabled()) {
+      fmt::print(" {:>10} {:>12} {:>12}", phase.allocations / iterations,
+                 phase.allocated_bytes / iterations, phase.peak_bytes);
+    }
+    fmt::println("");
+  }
+  fmt::println("  {:.1f} MB/s", bytes_per_second(result) / 1e6);
+}
+
+std::string to_json(std::vector<bench_result> const &results, int iterations) {
+  using std::chrono::nanoseconds;
+  auto ns = [](clock::duration d) {
+    return std::chrono::duration_cast<nanoseconds>(d).count();
+  };
+
+  std::string out = fmt::format("{{\n  \"iterations\": {},\n  \"results\": [",
+                                iterations);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    auto const &result = results[i];
+    out += fmt::format("{}\n    {{\n      \"solver\": \"{}\",\n"
+                       "      \"input\": \"{}\",\n"
+                       "      \"input_bytes\": {},\n"
+                       "      \"bytes_per_second\": {:.0f},\n"
+                       "      \"phases\": {{",
+                       i ? "," : "", aoc::json_escape(result.solver),
+                       aoc::json_escape(result.input.string()),
+                       result.input_bytes, bytes_per_second(result));
+    for (std::size_t p = 0; p < result.phases.size(); ++p) {
+      auto const &phase = result.phases[p];
+      auto stats = summarize(phase.elapsed);
+      out += fmt::format("{}\n        \"{}\": {{\"min_ns\": {}, "
+                         "\"median_ns\": {}, \"p99_ns\": {}",
+                         p ? "," : "", phase.name, ns(stats.min),
+                         ns(stats.median), ns(stats.p99));
+      if constexpr (aoc::alloc::enabled()) {
+        out += fmt::format(", \"allocations\": {}, \"allocated_bytes\": {}, "
+                           "\"peak_bytes\": {}",
+                           phase.allocations / iterations,
+                           phase.allocated_bytes / iterations,
+                           phase.peak_bytes);
+      }
+      out += "}";
+    }
+    out += "\n      }\n    }";
+  }
+  out += "\n  ]\n}\n";
+  return out;
+}
+
+void usage(std::string_view self) {
+  fmt::println("usage: {} [--root <dir>] [--inputs <dir>]... "
+               "[--iterations <n>] [--json <file>] [all | <day>...] "
+               "[-- <params>...]",
+               std::filesystem::path(self).filename().string());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+
+  auto args = parse_args(argc, argv);
+
+  std::filesystem::path root = ".";
+  // extra trees laid out like the repository, e.g. generated inputs
+  std::vector<std::filesystem::path> input_dirs;
+  std::optional<std::filesystem::path> json;
+  std::vector<std::string_view> selectors;
+  args_t params;
+  int iterations = 10;
+
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    if (args[i] == "--root" and i + 1 < args.size()) {
+      root = args[++i];
+    } else if (args[i] == "--inputs" and i + 1 < args.size()) {
+      input_dirs.emplace_back(args[++i]);
+    } else if (args[i] == "--json" and i + 1 < args.size()) {
+      json = args[++i];
+    } else if (args[i] == "--iterations" and i + 1 < args.size()) {
+      auto str = args[++i];
+      auto [ptr, ec] =
+          std::from_chars(str.data(), str.data() + str.size(), iterations);
+      if (ec != std::errc{} or iterations < 1) {
+        usage(args[0]);
+        return -1;
+      }
+    } else if (args[i] == "--") {
+      params.assign(args.begin() + i + 1, args.end());
+      break;
+    } else if (args[i].starts_with("-")) {
+      usage(args[0]);
+      return -1;
+    } else {
+      selectors.push_back(args[i]);
+    }
+  }
+
+  if (selectors.empty()) {
+    selectors.push_back("all");
+  }
+
+  std::vector<aoc::solver_info const *> selected;
+  for (auto const &solver : aoc::registry()) {
+    if (std::ranges::any_of(selectors, [&](std::string_view sel) {
+          return aoc::runner::matches(solver.name, sel);
+        })) {
+      selected.push_back(&solver);
+    }
+  }
+  std::ranges::sort(selected, [](auto const *l, auto const *r) {
+    return aoc::runner::natural_less(l->name, r->name);
+  });
+
+  int failed = 0;
+  std::vector<bench_result> results;
+  for (auto const *solver : selected) {
+    std::vector<std::filesystem::path> paths{root / solver->default_input};
+    for (auto const &dir : input_dirs) {
+      if (auto path = dir / solver->default_input;
+          std::filesystem::exists(path)) {
+        paths.push_back(path);
+      }
+    }
+
+    for (auto const &path : paths) {
+      std::optional<bench_result> result;
+      try {
+        result = bench(*solver, path, params, iterations);
+      } catch (std::exception const &e) {
+        fmt::println("{} failed: {}", solver->name, e.what());
+        ++failed;
+        continue;
+      }
+      if (!result) {
+        fmt::println("cannot open file: {}", path.string());
+        ++failed;
+        continue;
+      }
+      report(*result, iterations);
+      results.push_back(std::move(*result));
+    }
+  }
+
+  if (json) {
+    std::FILE *out = std::fopen(json->c_str(), "w");
+    if (!out) {
+      fmt::println("cannot open file: {}", json->string());
+      return -1;
+    }
+    fmt::print(out, "{}", to_json(results, iterations));
+    std::fclose(out);
+  }
+
+  return failed ? -1 : 0;
+}
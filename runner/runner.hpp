@@ -0,0 +1,184 @@
+#pragma once
+
+#include "alloc_tracker.hpp"
+#include "args.hpp"
+#include "instrument.hpp"
+#include "mapped_file.hpp"
+#include "perf_counters.hpp"
+#include "solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fmt/core.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aoc::runner {
+
+using clock = std::chrono::steady_clock;
+
+struct phase_result {
+  std::string_view name;
+  clock::duration elapsed;
+  std::optional<std::string> answer;
+  std::optional<perf::readings> counters;
+  alloc::usage heap;
+};
+
+struct run_result {
+  std::vector<phase_result> phases;
+  // what queries() returned, printed after the phases
+  std::vector<std::string> query_answers;
+
+  clock::duration total() const {
+    clock::duration sum{};
+    for (auto const &phase : phases) {
+      sum += phase.elapsed;
+    }
+    return sum;
+  }
+};
+
+template <typename Fn> clock::duration timed(Fn &&fn) {
+  auto start = clock::now();
+  fn();
+  return clock::now() - start;
+}
+
+// "day1" selects day1_task1 and day1_task2 but not day10
+inline bool matches(std::string_view solver_name, std::string_view selector) {
+  if (selector == "all" or solver_name == selector) {
+    return true;
+  }
+  return solver_name.starts_with(selector) and
+         solver_name[selector.size()] == '_';
+}
+
+// orders day2 before day10
+inline bool natural_less(std::string_view l, std::string_view r) {
+  auto day_of = [](std::string_view name) {
+    int day = 0;
+    auto first = std::min(name.find_first_of("0123456789"), name.size());
+    for (char c : name.substr(first)) {
+      if (c < '0' or c > '9') {
+        break;
+      }
+      day = day * 10 + (c - '0');
+    }
+    return day;
+  };
+  auto ld = day_of(l);
+  auto rd = day_of(r);
+  return ld != rd ? ld < rd : l < r;
+}
+
+// counters, when given, are read around every phase
+inline std::optional<run_result> run(solver_info const &solver,
+                                     std::filesystem::path const &input_path,
+                                     args_t const &params,
+                                     perf::counter_group *counters = nullptr) {
+  AOC_SCOPE(solver.name);
+  run_result result;
+
+  if (counters and !counters->available()) {
+    counters = nullptr;
+  }
+
+  auto phase = [&](std::string_view name, auto &&fn) {
+    AOC_SCOPE(name);
+    phase_result measured{name, {}, std::nullopt, std::nullopt, {}};
+    auto measure = [&] {
+      if (counters) {
+        counters->start();
+      }
+      measured.elapsed = timed(fn);
+      if (counters) {
+        measured.counters = counters->stop();
+      }
+    };
+    if constexpr (alloc::enabled()) {
+      alloc::window heap;
+      measure();
+      measured.heap = heap.close();
+    } else {
+      measure();
+    }
+    return measured;
+  };
+
+  mapped_file input;
+  result.phases.push_back(
+      phase("read", [&] { input = mapped_file(input_path); }));
+
+  if (!input.good()) {
+    fmt::println("cannot open file: {}", input_path.string());
+    return std::nullopt;
+  }
+
+  // a solver that throws fails on its own, the others still run
+  try {
+    auto solution = solver.make(params);
+
+    result.phases.push_back(
+        phase("parse", [&] { solution->parse(input.view()); }));
+
+    std::optional<std::string> answer;
+    auto part1 = phase("part1", [&] { answer = solution->part1(); });
+    if (answer) {
+      part1.answer = std::move(answer);
+      result.phases.push_back(std::move(part1));
+    }
+
+    auto part2 = phase("part2", [&] { answer = solution->part2(); });
+    if (answer) {
+      part2.answer = std::move(answer);
+      result.phases.push_back(std::move(part2));
+    }
+
+    std::optional<std::vector<std::string>> answers;
+    auto query = phase("query", [&] { answers = solution->queries(); });
+    if (answers) {
+      query.answer = fmt::format("{} answers", answers->size());
+      result.phases.push_back(std::move(query));
+      result.query_answers = std::move(*answers);
+    }
+  } catch (std::exception const &e) {
+    fmt::println("{} failed: {}", solver.name, e.what());
+    return std::nullopt;
+  }
+
+  return result;
+}
+
+inline double as_ms(clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+inline void report(solver_info const &solver, run_result const &result) {
+  fmt::println("{}", solver.name);
+  for (auto const &phase : result.phases) {
+    if (phase.answer) {
+      fmt::println("  {:<6} {:>12.3f} ms  -> {}", phase.name,
+                   as_ms(phase.elapsed), *phase.answer);
+    } else {
+      fmt::println("  {:<6} {:>12.3f} ms", phase.name, as_ms(phase.elapsed));
+    }
+    if constexpr (alloc::enabled()) {
+      fmt::println("  {:<6} allocs {}  bytes {}  peak {}", "",
+                   phase.heap.allocations, phase.heap.bytes,
+                   phase.heap.peak_bytes);
+    }
+    if (phase.counters) {
+      fmt::println("  {:<6} {}", "", perf::describe(*phase.counters));
+    }
+  }
+  fmt::println("  {:<6} {:>12.3f} ms", "total", as_ms(result.total()));
+  for (auto const &answer : result.query_answers) {
+    fmt::println("{}", answer);
+  }
+}
+
+} // namespace aoc::runner
@@ -0,0 +1,51 @@
+// entry point of the per-day executables, each one is linked with exactly
+// one solver object library
+#include "args.hpp"
+#include "log.hpp"
+#include "perf_counters.hpp"
+#include "runner.hpp"
+#include "solver.hpp"
+#include <filesystem>
+#include <fmt/core.h>
+#include <optional>
+
+int main(int argc, char **argv) {
+
+  auto args = parse_args(argc, argv);
+
+  // -v, -vv, -vvv ahead of the input raise the log verbosity, --perf adds
+  // hardware counters to the report
+  std::optional<aoc::perf::counter_group> counters;
+  std::size_t first = 1;
+  for (; first < args.size(); ++first) {
+    if (args[first] == "--perf") {
+      counters.emplace();
+    } else if (!aoc::log::parse_verbosity_flag(args[first])) {
+      break;
+    }
+  }
+
+  if (args.size() < first + 1) {
+    fmt::println("usage: {} [-v...] [--perf] <input_file> [params...]",
+                 std::filesystem::path(args[0]).filename().string());
+    return -1;
+  }
+
+  auto const &solvers = aoc::registry();
+  if (solvers.size() != 1) {
+    fmt::println("expected exactly one solver, found {}", solvers.size());
+    return -1;
+  }
+
+  args_t params(args.begin() + first + 1, args.end());
+
+  auto result = aoc::runner::run(solvers.front(), args[first], params,
+                                 counters ? &*counters : nullptr);
+  if (!result) {
+    return -1;
+  }
+
+  aoc::runner::report(solvers.front(), *result);
+
+  return 0;
+}